@@ -0,0 +1,563 @@
+// Benchmarks of the hot paths of every signal, with Google Benchmark
+// Build: g++ -std=c++20 -O2 -I../Source Signal.cpp -lbenchmark -pthread
+// Each benchmark reports ns/op (Time) and allocs/op, a steady state path that allocates is reported as an error
+// Stress, Reentrant and PriorityOrder check the dispatch while listeners change, build with -g -fsanitize=thread or
+// -g -fsanitize=address,undefined and run --benchmark_filter='Stress|Reentrant|PriorityOrder' to check them under sanitizers
+// The process exits with 1 if any benchmark reported an error
+// BaselineSignal is the signal before the slot map, its results are the reference of the others
+
+#include "CPPScriptSignal.hpp"
+#include "CPPScriptDelegate.hpp"
+#include "CPPConcurrentSignal.hpp"
+#include "CPPShardedSignal.hpp"
+#include "CPPKeyedSignal.hpp"
+#include "CPPBaselineSignal.hpp"
+#include <benchmark/benchmark.h>
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::milliseconds
+#include <cstdint> // std::uint64_t, UINT64_MAX
+#include <cstdlib> // std::malloc, std::free
+#include <deque> // std::deque
+#include <functional> // std::function
+#include <new> // std::bad_alloc
+#include <thread> // std::thread
+#include <utility> // std::declval, std::pair
+#include <vector> // std::vector
+
+// GCC pairs the malloc and free below across the inlined operators and warns falsely
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Number of allocations made by the process, counted by the global operator new
+static std::atomic<std::size_t> Allocated{0};
+
+void* operator new(std::size_t Size) {
+	Allocated.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* Memory = std::malloc(Size ? Size : 1)) {
+		return Memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t Size) {
+	return operator new(Size);
+}
+
+void operator delete(void* Memory) noexcept {
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory) noexcept {
+	std::free(Memory);
+}
+
+void operator delete(void* Memory, std::size_t) noexcept {
+	std::free(Memory);
+}
+
+void operator delete[](void* Memory, std::size_t) noexcept {
+	std::free(Memory);
+}
+
+// If any benchmark reported an error, read by main for the exit status
+static std::atomic<bool> Failed{false};
+
+// Report an error of a benchmark, that makes the process fail
+static void Fail(benchmark::State& State, const char* Message) {
+	Failed.store(true);
+	State.SkipWithError(Message);
+}
+
+// Counts the allocations made from its construction to its destruction, as allocs/op
+// A steady count fails the benchmark if any allocation is made, to catch regressions of the hot paths
+struct Allocations {
+	benchmark::State& State;
+	bool Steady;
+	std::size_t Start = Allocated.load(std::memory_order_relaxed);
+
+	Allocations(benchmark::State& Measured, bool Strict = false) : State(Measured), Steady(Strict) {}
+
+	~Allocations() {
+		const std::size_t Count = Allocated.load(std::memory_order_relaxed) - Start;
+		State.counters["allocs/op"] = benchmark::Counter(static_cast<double>(Count), benchmark::Counter::kAvgIterations);
+
+		if (Steady && Count) {
+			Fail(State, "allocated in steady state");
+		}
+	}
+};
+
+// Fire with 0, 1, 10 and 1000 listeners
+template <typename Signal> static void FireListeners(benchmark::State& State) {
+	Signal Fired;
+	int Sum = 0;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect([&Sum](int Value) { Sum += Value; });
+	}
+
+	{
+		Allocations Count(State, true);
+
+		for (auto _ : State) {
+			Fired.Fire(1);
+		}
+	}
+
+	benchmark::DoNotOptimize(Sum);
+	State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+BENCHMARK_TEMPLATE(FireListeners, BaselineSignal<int>)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(FireListeners, ScriptSignal<int>)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(FireListeners, FinalSignal<int>)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(FireListeners, InlineSignal<int>)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(FireListeners, ConcurrentSignal<int>)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+// Fire of 10 listeners with payloads of growing size, passed by reference
+template <std::size_t Size> static void FirePayload(benchmark::State& State) {
+	using Payload = std::array<char, Size>;
+	ScriptSignal<Payload> Fired;
+	Payload Value{};
+	int Sum = 0;
+
+	for (int Index = 0; Index < 10; ++Index) {
+		Fired.Connect([&Sum](const Payload& Argument) { Sum += Argument[0]; });
+	}
+
+	Allocations Count(State, true);
+
+	for (auto _ : State) {
+		Fired.Fire(Value);
+		benchmark::DoNotOptimize(Sum);
+	}
+}
+
+BENCHMARK_TEMPLATE(FirePayload, 8);
+BENCHMARK_TEMPLATE(FirePayload, 64);
+BENCHMARK_TEMPLATE(FirePayload, 512);
+BENCHMARK_TEMPLATE(FirePayload, 4096);
+
+// Connect and disconnect a listener while others stay connected
+template <typename Signal> static void ConnectChurn(benchmark::State& State) {
+	Signal Fired;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect([](int) {});
+	}
+
+	// The first connection grows the storage, the next ones reuse its freed slot
+	Fired.Connect([](int) {}).Disconnect();
+
+	Allocations Count(State, true);
+
+	for (auto _ : State) {
+		auto Connection = Fired.Connect([](int) {});
+		Connection.Disconnect();
+	}
+}
+
+BENCHMARK_TEMPLATE(ConnectChurn, ScriptSignal<int>)->Arg(0)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(ConnectChurn, FinalSignal<int>)->Arg(0)->Arg(10)->Arg(1000);
+BENCHMARK_TEMPLATE(ConnectChurn, InlineSignal<int>)->Arg(0)->Arg(10)->Arg(1000);
+
+// Connect and disconnect a listener with BaselineSignal, the reference of ConnectChurn
+// Its connections are only freed with the signal, so the iterations are bounded to bound the memory
+static void BaselineChurn(benchmark::State& State) {
+	BaselineSignal<int> Fired;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect([](int) {});
+	}
+
+	Allocations Count(State);
+
+	for (auto _ : State) {
+		auto Connection = Fired.Connect([](int) {});
+		Connection->Disconnect();
+	}
+}
+
+BENCHMARK(BaselineChurn)->Arg(0)->Arg(10)->Arg(1000)->Iterations(1000000);
+
+// Reconnect a random listener among 16 of 4 priorities, then fire
+// Each fire must call the listeners from the highest priority, and those of the same priority in connection order
+template <typename Signal> static void PriorityOrder(benchmark::State& State) {
+	using Handle = decltype(std::declval<Signal&>().Connect({}, 0));
+
+	struct Listener {
+		Handle Connection;
+		int Priority;
+		std::uint64_t Since;
+	};
+
+	Signal Fired;
+	std::array<Listener, 16> Pool{};
+	std::vector<const Listener*> Called;
+	std::uint64_t Sequence = 0;
+	std::uint32_t Random = 0x9E3779B9u;
+	const char* Error = nullptr;
+
+	const auto Reconnect = [&](Listener& Target) {
+		Target.Connection.Disconnect();
+		Target.Since = ++Sequence;
+		Target.Connection = Fired.Connect([&Called, &Target](int) { Called.push_back(&Target); }, Target.Priority);
+	};
+
+	for (std::size_t Index = 0; Index < Pool.size(); ++Index) {
+		Pool[Index].Priority = static_cast<int>(Index % 4);
+		Reconnect(Pool[Index]);
+	}
+
+	Called.reserve(Pool.size());
+
+	for (auto _ : State) {
+		Random ^= Random << 13;
+		Random ^= Random >> 17;
+		Random ^= Random << 5;
+		Reconnect(Pool[Random % Pool.size()]);
+
+		Called.clear();
+		Fired.Fire(0);
+
+		if (Called.size() != Pool.size()) {
+			Error = "a fire didn't call every listener once";
+		}
+
+		for (std::size_t Index = 1; Index < Called.size(); ++Index) {
+			const Listener& Previous = *Called[Index - 1];
+			const Listener& Current = *Called[Index];
+
+			if (Previous.Priority < Current.Priority || (Previous.Priority == Current.Priority && Previous.Since > Current.Since)) {
+				Error = "a fire called the listeners out of order";
+			}
+		}
+	}
+
+	for (Listener& Target : Pool) {
+		Target.Connection.Disconnect();
+	}
+
+	if (Error) {
+		Fail(State, Error);
+	}
+}
+
+BENCHMARK_TEMPLATE(PriorityOrder, ScriptSignal<int>);
+BENCHMARK_TEMPLATE(PriorityOrder, FinalSignal<int>);
+
+// Connect and disconnect a keyed listener while other keys stay connected
+static void KeyedChurn(benchmark::State& State) {
+	KeyedSignal<int> Fired;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect(static_cast<int>(Index), [](int) {});
+	}
+
+	// The first connection grows the key's entry, the next ones reuse its freed slot
+	Fired.Connect(-1, [](int) {}).Disconnect();
+
+	Allocations Count(State, true);
+
+	for (auto _ : State) {
+		auto Connection = Fired.Connect(-1, [](int) {});
+		Connection.Disconnect();
+	}
+}
+
+BENCHMARK(KeyedChurn)->Arg(0)->Arg(10)->Arg(1000);
+
+// Fire of one key among many, that only calls its listener
+static void KeyedFire(benchmark::State& State) {
+	KeyedSignal<int> Fired;
+	int Sum = 0;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect(static_cast<int>(Index), [&Sum](int Value) { Sum += Value; });
+	}
+
+	Allocations Count(State, true);
+
+	for (auto _ : State) {
+		Fired.Fire(1);
+	}
+
+	benchmark::DoNotOptimize(Sum);
+}
+
+BENCHMARK(KeyedFire)->Arg(1)->Arg(1000);
+
+// Fire of a key without listeners among many sequential keys, that calls nothing
+static void KeyedMiss(benchmark::State& State) {
+	KeyedSignal<int> Fired;
+	int Sum = 0;
+
+	for (int64_t Index = 0; Index < State.range(0); ++Index) {
+		Fired.Connect(static_cast<int>(Index), [&Sum](int Value) { Sum += Value; });
+	}
+
+	Allocations Count(State, true);
+
+	for (auto _ : State) {
+		Fired.Fire(-1);
+	}
+
+	benchmark::DoNotOptimize(Sum);
+}
+
+BENCHMARK(KeyedMiss)->Arg(1)->Arg(1000)->Arg(100000);
+
+// Many threads firing the same signal at once
+template <typename Signal> static void FireContention(benchmark::State& State) {
+	static Signal& Shared = [] () -> Signal& {
+		static Signal Fired;
+
+		for (int Index = 0; Index < 10; ++Index) {
+			Fired.Connect([](int Value) { benchmark::DoNotOptimize(Value); });
+		}
+
+		return Fired;
+	}();
+
+	// Not strict: the count is process wide, so it includes what the other benchmark threads allocate while starting
+	Allocations Count(State);
+
+	for (auto _ : State) {
+		Shared.Fire(1);
+	}
+}
+
+BENCHMARK_TEMPLATE(FireContention, ConcurrentSignal<int>)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+BENCHMARK_TEMPLATE(FireContention, ShardedSignal<int>)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+// Many threads connecting, disconnecting, firing and waiting on the same signal in a random order
+// Each thread checks its listeners: called by each fire of the thread while connected, never after Disconnect returned
+template <typename Signal> static void Stress(benchmark::State& State) {
+	using Handle = decltype(std::declval<Signal&>().Connect({}));
+
+	struct Listener {
+		Handle Connection;
+		std::atomic<std::uint64_t>* Calls = nullptr;
+		std::uint64_t Seen = 0;
+	};
+
+	static Signal Shared;
+	std::deque<std::atomic<std::uint64_t>> Counters;
+	std::vector<std::pair<const std::atomic<std::uint64_t>*, std::uint64_t>> Frozen;
+	std::array<Listener, 8> Owned{};
+	std::uint32_t Random = 0x9E3779B9u * static_cast<std::uint32_t>(State.thread_index() + 1);
+	const char* Error = nullptr;
+
+	const auto Disconnect = [&Frozen](Listener& Entry) {
+		if (Entry.Calls) {
+			Entry.Connection.Disconnect();
+			Frozen.push_back({Entry.Calls, Entry.Calls->load()});
+			Entry = Listener();
+		}
+	};
+
+	for (auto _ : State) {
+		Random ^= Random << 13;
+		Random ^= Random >> 17;
+		Random ^= Random << 5;
+
+		Listener& Slot = Owned[Random % Owned.size()];
+
+		switch ((Random >> 8) % 4) {
+		case 0:
+			if (!Slot.Calls) {
+				std::atomic<std::uint64_t>* Calls = &Counters.emplace_back(0);
+				Slot.Calls = Calls;
+				Slot.Connection = Shared.Connect([Calls](int Value) { Calls->fetch_add(Value, std::memory_order_relaxed); });
+			}
+			break;
+		case 1:
+			Disconnect(Slot);
+			break;
+		case 2:
+			for (Listener& Entry : Owned) {
+				Entry.Seen = Entry.Calls ? Entry.Calls->load() : 0;
+			}
+
+			Shared.Fire(1);
+
+			for (const Listener& Entry : Owned) {
+				if (Entry.Calls && Entry.Calls->load() == Entry.Seen) {
+					Error = "a connected listener missed a fire";
+				}
+			}
+			break;
+		default:
+			Shared.WaitFor(std::chrono::microseconds(1));
+			break;
+		}
+	}
+
+	for (Listener& Entry : Owned) {
+		Disconnect(Entry);
+	}
+
+	for (const auto& [Calls, Count] : Frozen) {
+		if (Calls->load() != Count) {
+			Error = "a listener was called after Disconnect returned";
+		}
+	}
+
+	if (Error) {
+		Fail(State, Error);
+	}
+}
+
+// The iterations are bounded, so the runs stay short under sanitizers
+BENCHMARK_TEMPLATE(Stress, ConcurrentSignal<int>)->Threads(4)->Threads(8)->Iterations(20000)->UseRealTime();
+BENCHMARK_TEMPLATE(Stress, ShardedSignal<int>)->Threads(4)->Threads(8)->Iterations(20000)->UseRealTime();
+
+// Listeners connecting and disconnecting others, or themselves, in a random order while the signal fires
+// Each fire must call once every listener connected before it and not disconnected during it, and no listener
+// connected during it or disconnected before it
+template <typename Signal> static void Reentrant(benchmark::State& State) {
+	using Handle = decltype(std::declval<Signal&>().Connect({}));
+
+	struct Record {
+		std::uint64_t Since;
+		std::uint64_t Until = UINT64_MAX;
+		std::uint64_t Last = 0;
+	};
+
+	struct Listener {
+		Handle Connection;
+		Record* Entry = nullptr;
+	};
+
+	Signal Fired;
+	std::deque<Record> Records;
+	std::array<Listener, 32> Pool{};
+	std::uint64_t Sequence = 0;
+	std::uint32_t Random = 0x9E3779B9u;
+	const char* Error = nullptr;
+
+	const auto Next = [&Random] {
+		Random ^= Random << 13;
+		Random ^= Random >> 17;
+		Random ^= Random << 5;
+		return Random;
+	};
+
+	std::function<void(std::size_t)> Toggle;
+	Toggle = [&](std::size_t Index) {
+		Listener& Target = Pool[Index];
+
+		if (Target.Entry) {
+			Target.Connection.Disconnect();
+			Target.Entry->Until = Sequence;
+			Target = Listener();
+			return;
+		}
+
+		Record* Entry = &Records.emplace_back(Record{Sequence});
+		Target.Entry = Entry;
+		Target.Connection = Fired.Connect([&, Entry](std::uint64_t Fire) {
+			if (Fire <= Entry->Since || Fire > Entry->Until || Entry->Last == Fire) {
+				Error = "a fire called a listener it must not call";
+			}
+
+			Entry->Last = Fire;
+
+			if (Next() % 4 == 0) {
+				Toggle(Next() % Pool.size());
+			}
+		});
+	};
+
+	for (std::size_t Index = 0; Index < Pool.size(); Index += 2) {
+		Toggle(Index);
+	}
+
+	for (auto _ : State) {
+		Fired.Fire(++Sequence);
+
+		for (const Listener& Target : Pool) {
+			if (Target.Entry && Target.Entry->Since < Sequence && Target.Entry->Last != Sequence) {
+				Error = "a connected listener missed a fire";
+			}
+		}
+
+		Toggle(Next() % Pool.size());
+	}
+
+	for (Listener& Target : Pool) {
+		Target.Connection.Disconnect();
+	}
+
+	if (Error) {
+		Fail(State, Error);
+	}
+}
+
+BENCHMARK_TEMPLATE(Reentrant, ScriptSignal<std::uint64_t>)->Iterations(100000);
+BENCHMARK_TEMPLATE(Reentrant, FinalSignal<std::uint64_t>)->Iterations(100000);
+BENCHMARK_TEMPLATE(Reentrant, ConcurrentSignal<std::uint64_t>)->Iterations(100000);
+
+// Time from a fire to the return of a Wait in another thread, by spin count (0 always parks)
+static void WaitLatency(benchmark::State& State) {
+	ScriptSignal<> Fired;
+	std::atomic<bool> Ready{false};
+	std::atomic<bool> Stopping{false};
+	std::atomic<std::size_t> Woken{0};
+
+	// A signal without functions isn't fired at all, so it never wakes a waiter
+	Fired.Connect([] {});
+	Fired.Spin(static_cast<std::uint32_t>(State.range(0)));
+
+	std::thread Waiter([&] {
+		while (!Stopping.load()) {
+			Ready.store(true);
+
+			if (Fired.WaitFor(std::chrono::milliseconds(10))) {
+				Woken.fetch_add(1);
+			}
+		}
+	});
+
+	for (auto _ : State) {
+		State.PauseTiming();
+		while (!Ready.exchange(false)) {
+			std::this_thread::yield();
+		}
+
+		const std::size_t Seen = Woken.load();
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		State.ResumeTiming();
+
+		// A fire made before the waiter captured the generation is missed, so it is repeated
+		for (int Spin = 0; Woken.load() == Seen; ++Spin) {
+			if (Spin % 1000 == 0) {
+				Fired.Fire();
+			}
+
+			std::this_thread::yield();
+		}
+	}
+
+	Stopping.store(true);
+	Fired.Fire();
+	Waiter.join();
+}
+
+BENCHMARK(WaitLatency)->Arg(0)->Arg(128)->Arg(100000)->Iterations(1000)->UseRealTime();
+
+int main(int Count, char** Arguments) {
+	benchmark::Initialize(&Count, Arguments);
+
+	if (benchmark::ReportUnrecognizedArguments(Count, Arguments)) {
+		return 1;
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return Failed.load() ? 1 : 0;
+}
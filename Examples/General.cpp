@@ -18,14 +18,14 @@ int main() {
 	// Output: Hello Blue
 
 	// Verify if Hello's function still exist
-	std::cout << Hello->Connected() << '\n';
+	std::cout << Hello.Connected() << '\n';
 	// Output: 1
 
 	// After disconnect, the Hello's function don't exist anymore
-	Hello->Disconnect();
+	Hello.Disconnect();
 
 	// Now the connection don't have any function to use
-	std::cout << Hello->Connected() << '\n';
+	std::cout << Hello.Connected() << '\n';
 	// Output: 0
 
 	/* Now none of connections will receive this argument,
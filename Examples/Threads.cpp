@@ -1,7 +1,7 @@
 // See full documentation in header
 
 #include "CPPScriptSignal"
-#include <chrono> // std::chrono::milliseconds
+#include <chrono> // std::chrono::milliseconds, std::chrono::nanoseconds
 #include <thread> // std::thread, std::thread::sleep_for
 #include <iostream> // std::cout
 
@@ -23,10 +23,11 @@ int main() {
 		// After 5 seconds, the Welcome is fired
 		Welcome.Fire("Blue");
 		// Output: Hello Blue
-	}).join();
+	});
 
 	// Wait for all functions of connections to be called
-	long long Elapsed = Welcome.Wait();
+	std::chrono::nanoseconds Elapsed = Welcome.Wait();
+	Thread.join();
 
 	/** Note:
 	 * As the threads are independent of their execution, the thread above sleep
@@ -34,8 +35,14 @@ int main() {
 	 * waiting for this thread to call Welcome::Fire, simultaneously
 	 */
 
-	std::cout << "Welcome was fired in " << Elapsed << " milliseconds\n";
+	std::cout << "Welcome was fired in " << std::chrono::duration_cast<std::chrono::milliseconds>(Elapsed).count() << " milliseconds\n";
 	// Output: Welcome was fired in 5000 milliseconds
 
+	// Wait for at most 100 milliseconds, nobody will fire Welcome again
+	if (!Welcome.WaitFor(std::chrono::milliseconds(100))) {
+		std::cout << "Welcome wasn't fired\n";
+	}
+	// Output: Welcome wasn't fired
+
 	return 0;
 }
@@ -0,0 +1,449 @@
+#ifndef CPPConcurrentSignal
+#define CPPConcurrentSignal
+
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "CPPScriptSignal.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Depth of ConcurrentSignal::Fire calls in the current thread
+ *
+ * While a thread is firing any ConcurrentSignal, it can't wait for
+ * readers to leave (it is one of them), so it only retires snapshots
+ *
+ * @see ConcurrentSignal::Publish
+ */
+inline thread_local unsigned ConcurrentDepth = 0;
+
+/**
+ * @brief Class of signal that can be fired by many threads at once
+ *
+ * Listeners are kept in an immutable snapshot published by an atomic
+ * pointer. ConcurrentSignal::Fire never takes a lock, while
+ * ConcurrentSignal::Connect and Disconnect copy the snapshot, publish
+ * the copy and reclaim the old one after an epoch based grace period
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class ConcurrentSignal {
+protected:
+	/** Struct of a listener inside a snapshot */
+	struct Listener {
+		/** Unique identifier of the listener's connection */
+		std::uint64_t Id;
+
+		/** Function of the listener */
+		f_(ScriptArgument<Parameters>...) Function;
+	};
+
+	/** Immutable list of listeners read by ConcurrentSignal::Fire */
+	using Snapshot = std::vector<Listener>;
+
+public:
+	/**
+	 * @brief Struct of connection, a value handle to a listener
+	 *
+	 * Holds the signal and the listener's identifier only, so the signal
+	 * keeps nothing per connection and a disconnected listener leaves no
+	 * memory behind
+	 */
+	struct Connection {
+	protected:
+		/**
+		 * @brief Signal that owns the connection's function
+		 *
+		 * @see ConcurrentSignal::Connection::Disconnect
+		 */
+		ConcurrentSignal* Signal = nullptr;
+
+		/**
+		 * @brief Identifier of the connection's listener
+		 *
+		 * @see ConcurrentSignal::Listener::Id
+		 */
+		std::uint64_t Id = 0;
+
+	public:
+		/** Construct a connection that isn't connected to any signal */
+		Connection() = default;
+
+		/**
+		 * @brief Constructor of connection to direct initialize its handle
+		 *
+		 * @see ConcurrentSignal::Connect
+		 *
+		 * @param Owner Signal that holds the connection's function
+		 * @param Identifier Identifier of the connection's listener
+		 */
+		Connection(ConcurrentSignal* Owner, std::uint64_t Identifier) : Signal(Owner), Id(Identifier) {}
+
+		/**
+		 * @brief Return if connection's function exists or not
+		 *
+		 * @see ConcurrentSignal::Contains
+		 *
+		 * @return `true` if the listener is in the current snapshot
+		 */
+		inline bool Connected() const {
+			return Signal && Signal->Contains(Id);
+		}
+
+		/**
+		 * @brief Erase the connection's function from the signal
+		 *
+		 * @note Calling it again, or on a copy of a disconnected
+		 * connection, does nothing, even from many threads at once
+		 *
+		 * @see ConcurrentSignal::Erase
+		 */
+		void Disconnect() {
+			if (Signal) {
+				Signal->Erase(Id);
+			}
+		}
+	};
+
+protected:
+	/** Reader counter padded to its own cache line */
+	struct alignas(64) Counter {
+		/** Number of ConcurrentSignal::Fire inside the epoch */
+		std::atomic<std::size_t> Value{0};
+	};
+
+	/**
+	 * @brief Current snapshot of listeners
+	 *
+	 * @see ConcurrentSignal::Fire
+	 * @see ConcurrentSignal::Publish
+	 */
+	std::atomic<const Snapshot*> Published;
+
+	/**
+	 * @brief Current epoch, its parity selects the reader counter
+	 *
+	 * @see ConcurrentSignal::Enter
+	 * @see ConcurrentSignal::Synchronize
+	 */
+	std::atomic<std::uint64_t> Epoch{0};
+
+	/**
+	 * @brief Number of readers that entered in each epoch parity
+	 *
+	 * @see ConcurrentSignal::Enter
+	 */
+	Counter Readers[2];
+
+	/**
+	 * @brief Serialize the writers of ConcurrentSignal::Published
+	 *
+	 * @see ConcurrentSignal::Connect
+	 * @see ConcurrentSignal::Erase
+	 */
+	std::mutex Writing;
+
+	/**
+	 * @brief Serialize the epoch flips of ConcurrentSignal::Synchronize
+	 *
+	 * @note Separated from Writing, so a writer waiting for readers
+	 * never holds the lock that a firing reader might need
+	 */
+	std::mutex Reclaiming;
+
+	/**
+	 * @brief Snapshots replaced but maybe still read by some Fire
+	 *
+	 * @see ConcurrentSignal::Publish
+	 */
+	std::vector<const Snapshot*> Retired;
+
+	/**
+	 * @brief Identifier of the next connection
+	 *
+	 * @see ConcurrentSignal::Connect
+	 */
+	std::uint64_t Next = 0;
+
+	/**
+	 * @brief Waiting machinery of ConcurrentSignal::Wait
+	 *
+	 * @see ConcurrentSignal::Fire
+	 * @see ConcurrentSignal::Wait
+	 */
+	ScriptWaiter Waiter;
+
+	/**
+	 * @brief Register the current thread as a reader of the current epoch
+	 *
+	 * The counter is increased and the epoch is checked again, if it
+	 * changed in the middle the writer may have missed the counter,
+	 * so the thread retries in the new epoch
+	 *
+	 * @return std::size_t Parity of the reader counter to be decreased
+	 */
+	std::size_t Enter() {
+		for (;;) {
+			const std::uint64_t Seen = Epoch.load();
+			std::atomic<std::size_t>& Count = Readers[Seen & 1].Value;
+
+			Count.fetch_add(1);
+			if (Epoch.load() == Seen) {
+				return Seen & 1;
+			}
+
+			Count.fetch_sub(1);
+		}
+	}
+
+	/**
+	 * @brief Wait until every reader active at the call has left
+	 *
+	 * Flips the epoch twice, waiting each time for the readers of
+	 * the previous parity to leave, as new readers always enter
+	 * the other parity
+	 */
+	void Synchronize() {
+		std::lock_guard<std::mutex> Hold(Reclaiming);
+
+		for (int Phase = 0; Phase < 2; ++Phase) {
+			const std::uint64_t Previous = Epoch.fetch_add(1);
+
+			while (Readers[Previous & 1].Value.load() != 0) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/**
+	 * @brief Replace the current snapshot and reclaim the old ones
+	 *
+	 * Must be called with Writing locked, that is released before
+	 * waiting for readers. If the current thread is firing a signal,
+	 * the snapshots stay retired until the next writer outside of Fire
+	 *
+	 * @param Lock Lock holding ConcurrentSignal::Writing
+	 * @param Replacement Snapshot to be published
+	 */
+	void Publish(std::unique_lock<std::mutex>& Lock, const Snapshot* Replacement) {
+		Retired.push_back(Published.exchange(Replacement));
+
+		if (ConcurrentDepth != 0) {
+			return;
+		}
+
+		std::vector<const Snapshot*> Reclaimed;
+		Reclaimed.swap(Retired);
+		Lock.unlock();
+
+		Synchronize();
+		for (const auto& Old : Reclaimed) {
+			delete Old;
+		}
+	}
+
+	/**
+	 * @brief Find a listener in a snapshot, listeners are sorted by identifier
+	 *
+	 * @param View Snapshot to be searched
+	 * @param Id Identifier of the listener
+	 *
+	 * @return Snapshot::const_iterator The listener, or the end of the snapshot
+	 */
+	static typename Snapshot::const_iterator Find(const Snapshot& View, std::uint64_t Id) {
+		const auto Found = std::lower_bound(View.begin(), View.end(), Id, [](const Listener& Entry, std::uint64_t Wanted) {
+			return Entry.Id < Wanted;
+		});
+
+		return Found != View.end() && Found->Id == Id ? Found : View.end();
+	}
+
+	/**
+	 * @brief Return if a listener is in the current snapshot
+	 *
+	 * @see ConcurrentSignal::Connection::Connected
+	 *
+	 * @param Id Identifier of the listener
+	 *
+	 * @return bool
+	 */
+	bool Contains(std::uint64_t Id) {
+		Reading Guard(*this);
+		const Snapshot* View = Published.load();
+		return Find(*View, Id) != View->end();
+	}
+
+	/**
+	 * @brief Publish a copy of the snapshot without a listener
+	 *
+	 * Nothing is published if the listener was already erased
+	 *
+	 * @see ConcurrentSignal::Connection::Disconnect
+	 *
+	 * @param Id Identifier of the listener to be erased
+	 */
+	void Erase(std::uint64_t Id) {
+		std::unique_lock<std::mutex> Lock(Writing);
+		const Snapshot* Old = Published.load();
+		const auto Erased = Find(*Old, Id);
+
+		if (Erased == Old->end()) {
+			return;
+		}
+
+		Snapshot* Copy = new Snapshot();
+		Copy->reserve(Old->size() - 1);
+		Copy->insert(Copy->end(), Old->begin(), Erased);
+		Copy->insert(Copy->end(), Erased + 1, Old->end());
+
+		Publish(Lock, Copy);
+	}
+
+	/**
+	 * @brief Leaves the reader epoch when Fire returns or throws
+	 *
+	 * @see ConcurrentSignal::Fire
+	 */
+	struct Reading {
+		/** Counter to be decreased */
+		std::atomic<std::size_t>& Count;
+
+		/** Enter a reader epoch of the signal */
+		Reading(ConcurrentSignal& Signal) : Count(Signal.Readers[Signal.Enter()].Value) {
+			++ConcurrentDepth;
+		}
+
+		/** Leave the reader epoch */
+		~Reading() {
+			--ConcurrentDepth;
+			Count.fetch_sub(1);
+		}
+	};
+
+public:
+	/** Construct the signal with an empty snapshot */
+	ConcurrentSignal() : Published(new Snapshot()) {}
+
+	/**
+	 * @brief Delete all snapshots and deconstruct Signal
+	 *
+	 * @note No thread may be firing the signal while it is deconstructed,
+	 * and its connections must not be used afterwards
+	 *
+	 * @see ConcurrentSignal::Retired
+	 */
+	virtual ~ConcurrentSignal() {
+		for (const auto& Old : Retired) {
+			delete Old;
+		}
+
+		delete Published.load();
+	}
+
+	/**
+	 * @brief Create a new connection and publish it's function
+	 *
+	 * Copies the current snapshot with the new function at the
+	 * end and publishes it, so Fire calls made after the return
+	 * see the new function
+	 *
+	 * @note Can be called from any thread, including from a listener
+	 *
+	 * @param Function Function or lambda to be used in connection
+	 *
+	 * @return ConcurrentSignal::Connection
+	 */
+	virtual Connection Connect(const f_(ScriptArgument<Parameters>...)& Function) {
+		std::unique_lock<std::mutex> Lock(Writing);
+		const Snapshot* Old = Published.load();
+		Snapshot* Copy = new Snapshot();
+		Copy->reserve(Old->size() + 1);
+		Copy->insert(Copy->end(), Old->begin(), Old->end());
+		Copy->push_back({Next, Function});
+
+		const Connection New(this, Next++);
+		Publish(Lock, Copy);
+		return New;
+	}
+
+	/**
+	 * @brief Call all functions of the current snapshot
+	 *
+	 * The snapshot is loaded inside a reader epoch, so it is not
+	 * deleted until the call returns, no lock is taken to read it
+	 *
+	 * @note Notifies all ConcurrentSignal::Wait waiting for
+	 * ConcurrentSignal::Fire to be called, the lock of the waiting
+	 * machinery is only taken when some thread is waiting
+	 *
+	 * @see ScriptArgument
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	virtual void Fire(ScriptArgument<Parameters>... Arguments) {
+		{
+			Reading Guard(*this);
+			const Snapshot* View = Published.load();
+
+			if (View->empty()) {
+				return;
+			}
+
+			for (const auto& Entry : *View) {
+				Entry.Function(Arguments...);
+			}
+		}
+
+		Waiter.Notify();
+	}
+
+	/**
+	 * @brief Wait for ConcurrentSignal::Fire to be called and return elapsed time
+	 *
+	 * @see ScriptWaiter::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for ConcurrentSignal::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		return Waiter.Wait();
+	}
+
+	/**
+	 * @brief Wait for ConcurrentSignal::Fire to be called for a duration
+	 *
+	 * @see ScriptWaiter::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return Waiter.WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for ConcurrentSignal::Fire to be called until a time point
+	 *
+	 * @see ScriptWaiter::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		return Waiter.WaitUntil(Time);
+	}
+};
+
+#undef f_
+#endif
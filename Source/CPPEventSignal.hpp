@@ -0,0 +1,206 @@
+#ifndef CPPEventSignal
+#define CPPEventSignal
+
+#if !defined(__linux__)
+#error "CPPEventSignal.hpp needs Linux eventfd"
+#endif
+
+#include <tuple>
+#include <cerrno>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <system_error>
+
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "CPPScriptSignal.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Class of signal fired by any thread and dispatched by a reactor
+ *
+ * EventSignal::Post can be called by any thread: it pushes the arguments
+ * to a lock-free queue and makes an eventfd readable. The thread owning
+ * the signal watches EventSignal::Descriptor with its reactor (epoll,
+ * poll or an io_uring poll), and calls EventSignal::Drain when it is
+ * readable, so no thread is dedicated to wait for the signal
+ *
+ * @note Connect, Fire and Drain must only be called by the owning thread
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class EventSignal final : public ScriptSignalBase<EventSignal<Parameters...>, f_(ScriptArgument<Parameters>...), Parameters...> {
+protected:
+	/** Base class holding the implementation */
+	using Base = ScriptSignalBase<EventSignal, f_(ScriptArgument<Parameters>...), Parameters...>;
+
+	/** Copy of the arguments of a posted fire */
+	using typename Base::Event;
+
+	/** Struct of a posted fire in EventSignal::Posted */
+	struct Node {
+		/** Copy of the arguments */
+		Event Arguments;
+
+		/** Fire posted before this one */
+		Node* Next;
+	};
+
+	/**
+	 * @brief Eventfd readable while some fire is posted and not drained
+	 *
+	 * @see EventSignal::Descriptor
+	 */
+	int Handle;
+
+	/**
+	 * @brief Last posted fire, a lock-free stack drained at once
+	 *
+	 * @see EventSignal::Post
+	 * @see EventSignal::Drain
+	 */
+	std::atomic<Node*> Posted{nullptr};
+
+	/**
+	 * @brief If EventSignal::Handle was written since the last drain
+	 *
+	 * Only the first post after a drain writes the eventfd, so a burst
+	 * of posts makes a single wake up of the reactor
+	 */
+	std::atomic<bool> Signaled{false};
+
+	/** Create the eventfd, or throw `std::system_error` */
+	static int Open() {
+		const int Created = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if (Created < 0) {
+			throw std::system_error(errno, std::generic_category(), "eventfd");
+		}
+
+		return Created;
+	}
+
+public:
+	/** Connection returned by EventSignal::Connect */
+	using typename Base::Connection;
+
+	/** Construct the signal and its eventfd, throws `std::system_error` if it can't be created */
+	EventSignal() : Handle(Open()) {}
+
+	/**
+	 * @brief Construct the signal with a name shown by tracing
+	 *
+	 * @see ScriptSignalBase::ScriptSignalBase(const char*)
+	 *
+	 * @param Label Name of the signal
+	 */
+	explicit EventSignal(const char* Label) : Base(Label), Handle(Open()) {}
+
+	EventSignal(const EventSignal&) = delete;
+	EventSignal& operator=(const EventSignal&) = delete;
+
+	/**
+	 * @brief Close the eventfd and delete the fires not drained
+	 *
+	 * @note The reactor must stop watching the descriptor first, and no
+	 * thread may be posting to the signal
+	 */
+	~EventSignal() {
+		for (Node* Current = Posted.exchange(nullptr); Current;) {
+			delete std::exchange(Current, Current->Next);
+		}
+
+		close(Handle);
+	}
+
+	/**
+	 * @brief Return the eventfd to be watched for readability by the reactor
+	 *
+	 * @return int
+	 */
+	inline int Descriptor() const {
+		return Handle;
+	}
+
+	/**
+	 * @brief Post a fire to be dispatched by the owning thread's EventSignal::Drain
+	 *
+	 * The arguments are copied in a node pushed with a single
+	 * compare-and-swap, then the eventfd is written if it wasn't since the
+	 * last drain
+	 *
+	 * @note Can be called from any thread, including from a listener
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Post(ScriptArgument<Parameters>... Arguments) {
+		Node* Created = new Node{Event(Arguments...), Posted.load(std::memory_order_relaxed)};
+
+		while (!Posted.compare_exchange_weak(Created->Next, Created, std::memory_order_seq_cst, std::memory_order_relaxed)) {}
+
+		if (!Signaled.exchange(true, std::memory_order_seq_cst)) {
+			const std::uint64_t One = 1;
+			[[maybe_unused]] const ssize_t Written = write(Handle, &One, sizeof(One));
+		}
+	}
+
+	/**
+	 * @brief Dispatch every posted fire, in posting order
+	 *
+	 * Clears the eventfd, then takes the whole queue at once. A fire
+	 * posted after the queue was taken writes the eventfd again, so it
+	 * is never left without a wake up
+	 *
+	 * @note Clearing the flag and taking the queue are seq_cst, like the
+	 * push and the flag check of EventSignal::Post, so the clear can't
+	 * become visible after the take and be missed by a post in between
+	 *
+	 * @note Call it from the owning thread when EventSignal::Descriptor is readable.
+	 * If a function throws, the fire and the ones left in the taken queue are dropped
+	 *
+	 * @return std::size_t Number of fires dispatched
+	 */
+	std::size_t Drain() {
+		std::uint64_t Count;
+		[[maybe_unused]] const ssize_t Read = read(Handle, &Count, sizeof(Count));
+		Signaled.store(false, std::memory_order_seq_cst);
+
+		Node* Reversed = nullptr;
+		for (Node* Current = Posted.exchange(nullptr, std::memory_order_seq_cst); Current;) {
+			Node* Next = Current->Next;
+			Current->Next = Reversed;
+			Reversed = Current;
+			Current = Next;
+		}
+
+		struct Remaining {
+			/** Fires not dispatched yet */
+			Node*& List;
+
+			/** Delete the fires left when a function throws */
+			~Remaining() {
+				while (List) {
+					delete std::exchange(List, List->Next);
+				}
+			}
+		} Guard{Reversed};
+
+		std::size_t Dispatched = 0;
+		while (Reversed) {
+			std::apply([this](auto&... Values) { this->Fire(Values...); }, Reversed->Arguments);
+			delete std::exchange(Reversed, Reversed->Next);
+			++Dispatched;
+		}
+
+		return Dispatched;
+	}
+};
+
+#undef f_
+#endif
@@ -0,0 +1,626 @@
+#ifndef CPPKeyedSignal
+#define CPPKeyedSignal
+
+#include <bit>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <functional>
+
+#include "CPPScriptSignal.hpp"
+
+/**
+ * @brief Class of signal whose functions are connected to a key
+ *
+ * The first argument of KeyedSignal::Fire is the key, and only the
+ * functions connected to that key (plus the wildcard functions
+ * connected to every key) are called, so a fire costs the matching
+ * functions instead of all of them
+ *
+ * Functions are grouped by key in a flat open addressing table, each
+ * group holding a small dense vector of its functions
+ *
+ * @tparam Key The type of the first parameter, used to select the functions
+ * @tparam Parameters The other parameters to be used in function of connection
+ */
+template <typename Key, typename... Parameters> class KeyedSignal {
+public:
+	/** Type of the function of each connection, taking the key first */
+	using Function = std::function<void(ScriptArgument<Key>, ScriptArgument<Parameters>...)>;
+
+	/**
+	 * @brief Struct of connection
+	 *
+	 * A small value handle, like ScriptSignalBase::Connection
+	 */
+	struct Connection {
+	protected:
+		/**
+		 * @brief Signal that owns the connection's function or `nullptr`
+		 *
+		 * @see KeyedSignal::Connection::Disconnect
+		 */
+		KeyedSignal* Signal = nullptr;
+
+		/**
+		 * @brief Index of the connection's slot in KeyedSignal::Slots
+		 *
+		 * @see KeyedSignal::Slot
+		 */
+		std::size_t Index = 0;
+
+		/**
+		 * @brief Generation of the slot when the connection was made
+		 *
+		 * @see KeyedSignal::Slot::Generation
+		 */
+		std::uint32_t Generation = 0;
+
+	public:
+		/** Construct a connection to nothing, that is never connected */
+		Connection() = default;
+
+		/**
+		 * @brief Constructor of connection to direct initialize its handle
+		 *
+		 * @see KeyedSignal::Connect
+		 *
+		 * @param Owner Signal that holds the connection's function
+		 * @param Slot Index of the connection's slot
+		 * @param Current Generation of the slot
+		 */
+		Connection(KeyedSignal* Owner, std::size_t Slot, std::uint32_t Current) : Signal(Owner), Index(Slot), Generation(Current) {}
+
+		/**
+		 * @brief Return if connection's function exists or not
+		 *
+		 * @return `true` if the slot's generation still matches
+		 */
+		inline bool Connected() const {
+			return Signal && Signal->Slots[Index].Generation == Generation;
+		}
+
+		/**
+		 * @brief Erase the connection's function from the signal
+		 *
+		 * @note Calling it on a disconnected connection does nothing
+		 *
+		 * @see KeyedSignal::Erase
+		 */
+		void Disconnect() {
+			if (Signal) {
+				Signal->Erase(Index, Generation);
+			}
+		}
+	};
+
+protected:
+	/**
+	 * @brief Struct of a slot in KeyedSignal::Slots
+	 *
+	 * @see ScriptSignalBase::Slot
+	 */
+	struct Slot {
+		/** Index in KeyedSignal::Groups, or KeyedSignal::None for a wildcard function */
+		std::size_t Owner;
+
+		/** Index in the group's functions, next free slot or KeyedSignal::None while deferred */
+		std::size_t Position;
+
+		/** Increased each time the slot's function is erased */
+		std::uint32_t Generation;
+	};
+
+	/** Struct of the functions connected to a key */
+	struct Group {
+		/** Key of the group, empty if the table entry is unused */
+		std::optional<Key> Value;
+
+		/** Dense vector of the group's functions */
+		std::vector<Function> Functions;
+
+		/** The slot of each function */
+		std::vector<std::size_t> Owners;
+
+		/** If each function was erased during a fire */
+		std::vector<std::uint8_t> Dead;
+	};
+
+	/**
+	 * @brief Struct of a connection made during a fire
+	 *
+	 * @see KeyedSignal::Incoming
+	 */
+	struct Deferred {
+		/** Key of the connection, empty for a wildcard function */
+		std::optional<Key> Value;
+
+		/** Function of the connection */
+		Function Listener;
+
+		/** Index of the connection's slot in KeyedSignal::Slots */
+		std::size_t Index;
+
+		/** Generation of the slot when connected */
+		std::uint32_t Generation;
+	};
+
+	/** Marks the end of the free slots list, a wildcard slot and a deferred slot */
+	static constexpr std::size_t None = static_cast<std::size_t>(-1);
+
+	/**
+	 * @brief Open addressing table of groups, with linear probing
+	 *
+	 * @note Its size is zero or a power of two, kept at most half full
+	 *
+	 * @see KeyedSignal::Find
+	 */
+	std::vector<Group> Groups;
+
+	/**
+	 * @brief Number of used entries in KeyedSignal::Groups
+	 *
+	 * @see KeyedSignal::Rehash
+	 */
+	std::size_t Used = 0;
+
+	/**
+	 * @brief Functions called by every fire, whatever the key
+	 *
+	 * @see KeyedSignal::Connect(Function)
+	 */
+	Group Wildcards;
+
+	/**
+	 * @brief A vector of all slots, used and free
+	 *
+	 * @see KeyedSignal::Slot
+	 */
+	std::vector<Slot> Slots;
+
+	/**
+	 * @brief First free slot in KeyedSignal::Slots
+	 *
+	 * @see KeyedSignal::None
+	 */
+	std::size_t Free = None;
+
+	/**
+	 * @brief Slots whose function was erased during a fire
+	 *
+	 * @see KeyedSignal::Compact
+	 */
+	std::vector<std::size_t> Doomed;
+
+	/**
+	 * @brief Connections made during a fire
+	 *
+	 * @see KeyedSignal::Compact
+	 */
+	std::vector<Deferred> Incoming;
+
+	/**
+	 * @brief Number of fires running, including fires made by a function
+	 *
+	 * @see KeyedSignal::Dispatching
+	 */
+	std::size_t Depth = 0;
+
+	/**
+	 * @brief Waiting machinery of KeyedSignal::Wait
+	 *
+	 * @see KeyedSignal::Fire
+	 * @see KeyedSignal::Wait
+	 */
+	ScriptWaiter Waiter;
+
+	/**
+	 * @brief Return the home entry of a key in KeyedSignal::Groups
+	 *
+	 * The hash is mixed by a Fibonacci multiplication and the entry taken
+	 * from its high bits, as `std::hash` is the identity for integers in
+	 * common libraries, and sequential keys would otherwise fill a single
+	 * run of entries that every missing key and every release walks
+	 *
+	 * @param Value Key to be hashed
+	 *
+	 * @return std::size_t
+	 */
+	inline std::size_t Home(const Key& Value) const {
+		const std::uint64_t Mixed = static_cast<std::uint64_t>(std::hash<Key>()(Value)) * 0x9E3779B97F4A7C15ull;
+		return static_cast<std::size_t>(Mixed >> (64 - std::countr_zero(Groups.size())));
+	}
+
+	/**
+	 * @brief Return the entry of a key in KeyedSignal::Groups
+	 *
+	 * @param Value Key to be found
+	 *
+	 * @return std::size_t Index of the key's group, or of the unused entry where it would be
+	 */
+	std::size_t Probe(const Key& Value) const {
+		std::size_t Entry = Home(Value);
+
+		while (Groups[Entry].Value && !(*Groups[Entry].Value == Value)) {
+			Entry = (Entry + 1) & (Groups.size() - 1);
+		}
+
+		return Entry;
+	}
+
+	/**
+	 * @brief Return the group of a key
+	 *
+	 * @param Value Key to be found
+	 *
+	 * @return Group* The key's group, or `nullptr` if no function is connected to it
+	 */
+	Group* Find(const Key& Value) {
+		if (Used == 0) {
+			return nullptr;
+		}
+
+		Group& Found = Groups[Probe(Value)];
+		return Found.Value ? &Found : nullptr;
+	}
+
+	/**
+	 * @brief Return the group of a slot's function
+	 *
+	 * @param Index Index of the slot in KeyedSignal::Slots
+	 *
+	 * @return Group&
+	 */
+	inline Group& Of(std::size_t Index) {
+		const std::size_t Owner = Slots[Index].Owner;
+		return Owner == None ? Wildcards : Groups[Owner];
+	}
+
+	/**
+	 * @brief Move a group to another entry of KeyedSignal::Groups
+	 *
+	 * @param From Entry of the group
+	 * @param To Unused entry
+	 */
+	void Move(std::size_t From, std::size_t To) {
+		Groups[To] = std::move(Groups[From]);
+		Groups[From].Value.reset();
+
+		for (const auto& Owner : Groups[To].Owners) {
+			Slots[Owner].Owner = To;
+		}
+	}
+
+	/** Double the size of KeyedSignal::Groups, moving every group to its new entry */
+	void Rehash() {
+		std::vector<Group> Previous(Groups.empty() ? 8 : Groups.size() * 2);
+		Previous.swap(Groups);
+
+		for (auto& Entry : Previous) {
+			if (Entry.Value) {
+				const std::size_t Target = Probe(*Entry.Value);
+				Groups[Target] = std::move(Entry);
+
+				for (const auto& Owner : Groups[Target].Owners) {
+					Slots[Owner].Owner = Target;
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Free an empty entry of KeyedSignal::Groups
+	 *
+	 * Uses backward shift deletion: the groups after the entry that
+	 * probed past it are moved back, so lookups never need tombstones
+	 *
+	 * @param Entry Entry of the empty group
+	 */
+	void Release(std::size_t Entry) {
+		const std::size_t Mask = Groups.size() - 1;
+		Groups[Entry].Value.reset();
+		--Used;
+
+		for (std::size_t Next = (Entry + 1) & Mask; Groups[Next].Value; Next = (Next + 1) & Mask) {
+			if (((Next - Home(*Groups[Next].Value)) & Mask) >= ((Next - Entry) & Mask)) {
+				Move(Next, Entry);
+				Entry = Next;
+			}
+		}
+	}
+
+	/**
+	 * @brief Insert a function in the group of its key
+	 *
+	 * @note Must not be called during a fire
+	 *
+	 * @param Index Index of the function's slot in KeyedSignal::Slots
+	 * @param Value Key of the function, empty for a wildcard function
+	 * @param Listener Function to be inserted
+	 */
+	void Insert(std::size_t Index, std::optional<Key>&& Value, Function&& Listener) {
+		std::size_t Owner = None;
+
+		if (Value) {
+			if ((Used + 1) * 2 > Groups.size()) {
+				Rehash();
+			}
+
+			Owner = Probe(*Value);
+			if (!Groups[Owner].Value) {
+				Groups[Owner].Value = std::move(Value);
+				++Used;
+			}
+		}
+
+		Group& Target = Owner == None ? Wildcards : Groups[Owner];
+		Slots[Index].Owner = Owner;
+		Slots[Index].Position = Target.Functions.size();
+		Target.Functions.push_back(std::move(Listener));
+		Target.Owners.push_back(Index);
+		Target.Dead.push_back(0);
+	}
+
+	/**
+	 * @brief Remove the function of a slot and free the slot
+	 *
+	 * The last function of the group is moved into the erased
+	 * position, and a group left empty frees its table entry
+	 *
+	 * @note Must not be called during a fire
+	 *
+	 * @param Index Index of the slot in KeyedSignal::Slots
+	 */
+	void Remove(std::size_t Index) {
+		Slot& Target = Slots[Index];
+		Group& Owner = Of(Index);
+		const std::size_t Last = Owner.Functions.size() - 1;
+
+		if (Target.Position != Last) {
+			Owner.Functions[Target.Position] = std::move(Owner.Functions[Last]);
+			Owner.Owners[Target.Position] = Owner.Owners[Last];
+			Owner.Dead[Target.Position] = Owner.Dead[Last];
+			Slots[Owner.Owners[Target.Position]].Position = Target.Position;
+		}
+
+		Owner.Functions.pop_back();
+		Owner.Owners.pop_back();
+		Owner.Dead.pop_back();
+
+		if (Owner.Functions.empty() && Target.Owner != None) {
+			Release(Target.Owner);
+		}
+
+		Target.Position = Free;
+		Free = Index;
+	}
+
+	/**
+	 * @brief Erase the function of a slot, if the generation still matches
+	 *
+	 * During a fire the function is only marked dead, and removed by
+	 * KeyedSignal::Compact after the outermost fire returns
+	 *
+	 * @see ScriptSignalBase::Erase
+	 *
+	 * @param Index Index of the slot in KeyedSignal::Slots
+	 * @param Generation Generation of the slot held by the connection
+	 */
+	void Erase(std::size_t Index, std::uint32_t Generation) {
+		Slot& Target = Slots[Index];
+
+		if (Target.Generation != Generation) {
+			return;
+		}
+
+		++Target.Generation;
+
+		if (Depth == 0) {
+			Remove(Index);
+		} else if (Target.Position != None) {
+			Of(Index).Dead[Target.Position] = 1;
+			Doomed.push_back(Index);
+		}
+	}
+
+	/**
+	 * @brief Take a slot and connect a function, or defer it during a fire
+	 *
+	 * @param Value Key of the function, empty for a wildcard function
+	 * @param Listener Function to be connected
+	 *
+	 * @return KeyedSignal::Connection
+	 */
+	Connection Attach(std::optional<Key>&& Value, Function&& Listener) {
+		std::size_t Index = Free;
+
+		if (Index == None) {
+			Index = Slots.size();
+			Slots.push_back({None, 0, 0});
+		} else {
+			Free = Slots[Index].Position;
+		}
+
+		if (Depth == 0) {
+			Insert(Index, std::move(Value), std::move(Listener));
+		} else {
+			Slots[Index].Position = None;
+			Incoming.push_back({std::move(Value), std::move(Listener), Index, Slots[Index].Generation});
+		}
+
+		return Connection(this, Index, Slots[Index].Generation);
+	}
+
+	/**
+	 * @brief Remove the functions erased and connect the ones deferred during a fire
+	 *
+	 * @see KeyedSignal::Dispatching
+	 */
+	void Compact() {
+		for (const auto& Index : Doomed) {
+			Remove(Index);
+		}
+
+		Doomed.clear();
+
+		for (auto& Entry : Incoming) {
+			Slot& Target = Slots[Entry.Index];
+
+			if (Target.Generation == Entry.Generation) {
+				Insert(Entry.Index, std::move(Entry.Value), std::move(Entry.Listener));
+			} else {
+				Target.Position = Free;
+				Free = Entry.Index;
+			}
+		}
+
+		Incoming.clear();
+	}
+
+	/**
+	 * @brief Marks a fire as running while it is in scope
+	 *
+	 * @see ScriptSignalBase::Dispatching
+	 */
+	struct Dispatching {
+		/** Signal being fired */
+		KeyedSignal& Signal;
+
+		/** Enter a fire of the signal */
+		Dispatching(KeyedSignal& Owner) : Signal(Owner) {
+			++Signal.Depth;
+		}
+
+		/** Leave the fire, compacting after the outermost one */
+		~Dispatching() {
+			if (--Signal.Depth == 0 && (!Signal.Doomed.empty() || !Signal.Incoming.empty())) {
+				Signal.Compact();
+			}
+		}
+	};
+
+	/**
+	 * @brief Call the functions of a group that weren't erased
+	 *
+	 * @param Target Group to be called
+	 * @param Value Key of the fire
+	 * @param Arguments Other arguments of the fire
+	 */
+	static void Call(Group& Target, ScriptArgument<Key> Value, ScriptArgument<Parameters>... Arguments) {
+		for (std::size_t Position = 0, Count = Target.Functions.size(); Position < Count; ++Position) {
+			if (!Target.Dead[Position]) {
+				Target.Functions[Position](Value, Arguments...);
+			}
+		}
+	}
+
+public:
+	/** Construct a signal without functions */
+	KeyedSignal() = default;
+
+	KeyedSignal(const KeyedSignal&) = delete;
+	KeyedSignal& operator=(const KeyedSignal&) = delete;
+
+	/**
+	 * @brief Create a new connection whose function is called by the fires of a key
+	 *
+	 * A connection made during a fire is deferred, its function is first
+	 * called by the next fire after the outermost one returns
+	 *
+	 * @param Value Key of the fires calling the function
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return KeyedSignal::Connection
+	 */
+	Connection Connect(const Key& Value, Function Listener) {
+		return Attach(std::optional<Key>(Value), std::move(Listener));
+	}
+
+	/**
+	 * @brief Create a new connection whose function is called by every fire
+	 *
+	 * @see KeyedSignal::Connect(const Key&, Function)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return KeyedSignal::Connection
+	 */
+	Connection Connect(Function Listener) {
+		return Attach(std::nullopt, std::move(Listener));
+	}
+
+	/**
+	 * @brief Call the functions connected to a key, then the wildcard functions
+	 *
+	 * The key's group is found with a single hash lookup, so the fire
+	 * costs the called functions only
+	 *
+	 * @note Functions can connect and disconnect during the fire
+	 *
+	 * @see ScriptWaiter::Notify
+	 *
+	 * @param Value Key selecting the functions, passed to them as first argument
+	 * @param Arguments Other arguments in base of Signal's parameters
+	 */
+	void Fire(ScriptArgument<Key> Value, ScriptArgument<Parameters>... Arguments) {
+		Group* Found = Find(Value);
+
+		if (!Found && Wildcards.Functions.empty()) {
+			return;
+		}
+
+		{
+			Dispatching Guard(*this);
+
+			if (Found) {
+				Call(*Found, Value, Arguments...);
+			}
+
+			Call(Wildcards, Value, Arguments...);
+		}
+
+		Waiter.Notify();
+	}
+
+	/**
+	 * @brief Wait for KeyedSignal::Fire to call some function and return elapsed time
+	 *
+	 * @see ScriptWaiter::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for KeyedSignal::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		return Waiter.Wait();
+	}
+
+	/**
+	 * @brief Wait for KeyedSignal::Fire to call some function for a duration
+	 *
+	 * @see ScriptWaiter::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return Waiter.WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for KeyedSignal::Fire to call some function until a time point
+	 *
+	 * @see ScriptWaiter::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		return Waiter.WaitUntil(Time);
+	}
+};
+
+#endif
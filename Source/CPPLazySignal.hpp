@@ -0,0 +1,193 @@
+#ifndef CPPLazySignal
+#define CPPLazySignal
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <functional>
+
+#include "CPPScriptSignal.hpp"
+
+/**
+ * @brief Class of signal that is a single pointer until it is used
+ *
+ * Meant to be embedded in great numbers in objects whose signals are
+ * mostly never connected: the listener storage and the waiting machinery
+ * (a FinalSignal) are only allocated on the first LazySignal::Connect or
+ * LazySignal::Wait, and firing an unused signal is a single load
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class LazySignal {
+public:
+	/** Signal allocated on first use */
+	using Signal = FinalSignal<Parameters...>;
+
+	/** Connection returned by LazySignal::Connect */
+	using Connection = typename Signal::Connection;
+
+	/** Move-only connection that disconnects when deconstructed */
+	using ScopedConnection = typename Signal::ScopedConnection;
+
+protected:
+	/**
+	 * @brief The allocated signal, or `nullptr` while unused
+	 *
+	 * @see LazySignal::Get
+	 */
+	std::atomic<Signal*> Storage{nullptr};
+
+	/**
+	 * @brief Return the signal, allocating it if unused
+	 *
+	 * @note Threads racing on the first use allocate their own signal,
+	 * the first one published is kept and the others are deleted
+	 *
+	 * @return LazySignal::Signal&
+	 */
+	Signal& Get() {
+		Signal* Current = Storage.load(std::memory_order_acquire);
+
+		if (Current) {
+			return *Current;
+		}
+
+		Signal* Created = new Signal();
+
+		if (Storage.compare_exchange_strong(Current, Created, std::memory_order_acq_rel)) {
+			return *Created;
+		}
+
+		delete Created;
+		return *Current;
+	}
+
+public:
+	/** Construct an unused signal */
+	LazySignal() = default;
+
+	LazySignal(const LazySignal&) = delete;
+	LazySignal& operator=(const LazySignal&) = delete;
+
+	/** Delete the allocated signal, if any */
+	~LazySignal() {
+		delete Storage.load();
+	}
+
+	/**
+	 * @brief Return if the signal was never used
+	 *
+	 * @return `true` if nothing was allocated
+	 */
+	inline bool Unused() const {
+		return Storage.load(std::memory_order_acquire) == nullptr;
+	}
+
+	/**
+	 * @brief Create a new connection, allocating the signal if unused
+	 *
+	 * @see ScriptSignalBase::Connect
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return LazySignal::Connection
+	 */
+	Connection Connect(std::function<void(ScriptArgument<Parameters>...)> Listener) {
+		return Get().Connect(std::move(Listener));
+	}
+
+	/**
+	 * @brief Create a new connection with a priority, allocating the signal if unused
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function, higher is called first
+	 *
+	 * @return LazySignal::Connection
+	 */
+	Connection Connect(std::function<void(ScriptArgument<Parameters>...)> Listener, int Priority) {
+		return Get().Connect(std::move(Listener), Priority);
+	}
+
+	/**
+	 * @brief Create a connection called by the next fire only, allocating the signal if unused
+	 *
+	 * @see ScriptSignalBase::ConnectOnce
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return LazySignal::Connection
+	 */
+	Connection ConnectOnce(std::function<void(ScriptArgument<Parameters>...)> Listener) {
+		return Get().ConnectOnce(std::move(Listener));
+	}
+
+	/**
+	 * @brief Create a connection called by the next fire only with a priority, allocating the signal if unused
+	 *
+	 * @see ScriptSignalBase::ConnectOnce(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function, higher is called first
+	 *
+	 * @return LazySignal::Connection
+	 */
+	Connection ConnectOnce(std::function<void(ScriptArgument<Parameters>...)> Listener, int Priority) {
+		return Get().ConnectOnce(std::move(Listener), Priority);
+	}
+
+	/**
+	 * @brief Call all functions of the signal, if it was ever used
+	 *
+	 * @see ScriptSignalBase::Fire
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Fire(ScriptArgument<Parameters>... Arguments) {
+		if (Signal* Current = Storage.load(std::memory_order_acquire)) {
+			Current->Fire(Arguments...);
+		}
+	}
+
+	/**
+	 * @brief Wait for LazySignal::Fire to be called, allocating the signal if unused
+	 *
+	 * @see ScriptSignalBase::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for LazySignal::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		return Get().Wait();
+	}
+
+	/**
+	 * @brief Wait for LazySignal::Fire to be called for a duration
+	 *
+	 * @see ScriptSignalBase::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return Get().WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for LazySignal::Fire to be called until a time point
+	 *
+	 * @see ScriptSignalBase::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		return Get().WaitUntil(Time);
+	}
+};
+
+#endif
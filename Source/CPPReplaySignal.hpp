@@ -0,0 +1,298 @@
+#ifndef CPPReplaySignal
+#define CPPReplaySignal
+
+#include <array>
+#include <memory>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+
+#include "CPPScriptSignal.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Class of signal that keeps its last fires for late connections
+ *
+ * Each fire copies its arguments in a fixed ring of Capacity entries
+ * held inside the signal, so recording never allocates. A new
+ * connection is first called with the recorded fires (oldest first),
+ * so a component connecting late catches up without querying the state
+ *
+ * Every fire has a sequence number, ReplaySignal::WaitAfter returns at
+ * once if a fire newer than the caller's last seen one exists
+ *
+ * @note Only ReplaySignal::Fire records, a fire made by
+ * ScriptSignalBase::Flush or ScriptSignalBase::FireParallel isn't replayed
+ *
+ * @note ReplaySignal::Connect (with a function or a `std::weak_ptr`
+ * owner) and ReplaySignal::ConnectMany replay the history. ConnectOnce
+ * doesn't, its function is only called by the next fire, nor do Map
+ * and Forward, which track the fires from their call
+ *
+ * @tparam Capacity Number of fires kept
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <std::size_t Capacity, typename... Parameters> class ReplaySignal final : public ScriptSignalBase<ReplaySignal<Capacity, Parameters...>, f_(ScriptArgument<Parameters>...), Parameters...> {
+	static_assert(Capacity > 0, "ReplaySignal must keep at least one fire");
+
+protected:
+	/** Base class holding the implementation */
+	using Base = ScriptSignalBase<ReplaySignal, f_(ScriptArgument<Parameters>...), Parameters...>;
+
+	/** Copy of the arguments of a fire */
+	using typename Base::Event;
+
+	/** Function type of the listeners */
+	using Function = f_(ScriptArgument<Parameters>...);
+
+	/**
+	 * @brief The last fires, the fire of sequence S being at `S % Capacity`
+	 *
+	 * @see ReplaySignal::Fire
+	 */
+	std::array<std::optional<Event>, Capacity> History;
+
+	/**
+	 * @brief Number of fires recorded, the sequence of the last one
+	 *
+	 * @note Read by waiting threads, written by the firing thread
+	 *
+	 * @see ReplaySignal::Sequence
+	 */
+	std::atomic<std::uint64_t> Recorded{0};
+
+	/**
+	 * @brief Wait for a fire after Seen, or until Deadline
+	 *
+	 * @see ScriptWaiter::WaitReady
+	 *
+	 * @param Seen Last sequence seen by the caller
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
+	 *
+	 * @return std::optional<std::uint64_t> Sequence of the last fire, or empty if it timed out
+	 */
+	std::optional<std::uint64_t> Await(std::uint64_t Seen, const std::chrono::steady_clock::time_point* Deadline) {
+		std::uint64_t Last = 0;
+		const auto Ready = [this, Seen, &Last] {
+			Last = Recorded.load(std::memory_order_acquire);
+			return Last > Seen;
+		};
+
+		if (!this->Waiter.WaitReady(Ready, Deadline)) {
+			return std::nullopt;
+		}
+
+		return Last;
+	}
+
+public:
+	/** Connection returned by ReplaySignal::Connect */
+	using typename Base::Connection;
+
+	/** Group returned by ReplaySignal::ConnectMany */
+	using typename Base::ConnectionGroup;
+
+	/** Keep every overload of ScriptSignalBase::Connect visible, the ones declared below replay the history */
+	using Base::Connect;
+
+	/** Construct the signal, with a name or without */
+	using Base::Base;
+
+	/**
+	 * @brief Replay the recorded fires to a function, then connect it with priority 0
+	 *
+	 * @see ReplaySignal::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return ReplaySignal::Connection
+	 */
+	Connection Connect(Function Listener) {
+		return Connect(std::move(Listener), 0);
+	}
+
+	/**
+	 * @brief Replay the recorded fires to a function, then connect it with a priority
+	 *
+	 * @note During a fire, the replay includes the running fire, and the
+	 * connection is deferred as usual, so the function never gets it twice
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function
+	 *
+	 * @return ReplaySignal::Connection
+	 */
+	Connection Connect(Function Listener, int Priority) {
+		Replay(0, Listener);
+		return Base::Connect(std::move(Listener), Priority);
+	}
+
+	/**
+	 * @brief Replay the recorded fires to a method of an object owned by a `std::shared_ptr`, then connect it with priority 0
+	 *
+	 * @see ReplaySignal::Connect(const std::weak_ptr<Owner>&, Method, int)
+	 *
+	 * @param Target Owner of the object
+	 * @param Member Method to be called, or any callable taking the object first
+	 *
+	 * @return ReplaySignal::Connection
+	 */
+	template <typename Owner, typename Method> Connection Connect(const std::weak_ptr<Owner>& Target, Method Member) {
+		return Connect(Target, std::move(Member), 0);
+	}
+
+	/**
+	 * @brief Replay the recorded fires to a method of an object owned by a `std::shared_ptr`, then connect it
+	 *
+	 * @note An owner that already expired gets no replay and isn't connected
+	 *
+	 * @see ScriptSignalBase::Connect(const std::weak_ptr<Owner>&, Method, int)
+	 *
+	 * @param Target Owner of the object
+	 * @param Member Method to be called, or any callable taking the object first
+	 * @param Priority Priority of the function
+	 *
+	 * @return ReplaySignal::Connection
+	 */
+	template <typename Owner, typename Method> Connection Connect(const std::weak_ptr<Owner>& Target, Method Member, int Priority) {
+		if (const std::shared_ptr<Owner> Object = Target.lock()) {
+			Replay(0, [&Object, &Member](ScriptArgument<Parameters>... Arguments) {
+				std::invoke(Member, Object.get(), Arguments...);
+			});
+		}
+
+		return Base::Connect(Target, std::move(Member), Priority);
+	}
+
+	/**
+	 * @brief Replay the recorded fires to many functions, then connect them with priority 0
+	 *
+	 * @see ReplaySignal::ConnectMany(Range&&, int)
+	 *
+	 * @param Listeners Range of functions or lambdas to be used in connections
+	 *
+	 * @return ReplaySignal::ConnectionGroup
+	 */
+	template <typename Range> ConnectionGroup ConnectMany(Range&& Listeners) {
+		return ConnectMany(std::forward<Range>(Listeners), 0);
+	}
+
+	/**
+	 * @brief Replay the recorded fires to many functions, then connect them
+	 *
+	 * Each function gets the whole history before the next one
+	 *
+	 * @see ScriptSignalBase::ConnectMany(Range&&, int)
+	 *
+	 * @param Listeners Range of functions or lambdas to be used in connections
+	 * @param Priority Priority of the functions
+	 *
+	 * @return ReplaySignal::ConnectionGroup Group holding the connections
+	 */
+	template <typename Range> ConnectionGroup ConnectMany(Range&& Listeners, int Priority) {
+		for (auto& Listener : Listeners) {
+			Replay(0, Listener);
+		}
+
+		return Base::ConnectMany(std::forward<Range>(Listeners), Priority);
+	}
+
+	/**
+	 * @brief Record the fire, then call all functions
+	 *
+	 * The fire is recorded and ScriptSignalBase::Wait is notified even
+	 * without functions, so ReplaySignal::WaitAfter sees every fire
+	 *
+	 * @see ScriptSignalBase::Fire
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Fire(ScriptArgument<Parameters>... Arguments) {
+		const std::uint64_t Sequence = Recorded.load(std::memory_order_relaxed);
+		History[Sequence % Capacity].emplace(Arguments...);
+		Recorded.store(Sequence + 1, std::memory_order_release);
+
+		if (this->Functions.empty() && !this->Linked() && !this->Awaiting.load(std::memory_order_relaxed)) {
+			this->Waiter.Notify();
+			return;
+		}
+
+		Base::Fire(Arguments...);
+	}
+
+	/**
+	 * @brief Return the sequence of the last fire, `0` before the first one
+	 *
+	 * @return std::uint64_t
+	 */
+	inline std::uint64_t Sequence() const {
+		return Recorded.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Call a function with the recorded fires after a sequence, oldest first
+	 *
+	 * Fires older than the last Capacity ones are lost and skipped
+	 *
+	 * @note Must be called by the firing thread
+	 *
+	 * @param Seen Last sequence seen by the caller, `0` for all recorded fires
+	 * @param Listener Function called with the arguments of each fire
+	 *
+	 * @return std::uint64_t Sequence of the last fire, to be passed as the next Seen
+	 */
+	template <typename Callable> std::uint64_t Replay(std::uint64_t Seen, Callable&& Listener) {
+		const std::uint64_t Last = Recorded.load(std::memory_order_relaxed);
+		const std::uint64_t First = Last > Capacity ? std::max(Seen, Last - Capacity) : Seen;
+
+		for (std::uint64_t Sequence = First; Sequence < Last; ++Sequence) {
+			std::apply(Listener, *History[Sequence % Capacity]);
+		}
+
+		return Last;
+	}
+
+	/**
+	 * @brief Wait for a fire newer than a sequence, returning at once if one already exists
+	 *
+	 * @code
+	 * std::uint64_t Seen = Loaded.Sequence();
+	 * Seen = Loaded.WaitAfter(Seen);
+	 * @endcode
+	 *
+	 * @param Seen Last sequence seen by the caller
+	 *
+	 * @return std::uint64_t Sequence of the last fire
+	 */
+	std::uint64_t WaitAfter(std::uint64_t Seen) {
+		return *Await(Seen, nullptr);
+	}
+
+	/**
+	 * @brief Wait for a fire newer than a sequence for a duration
+	 *
+	 * @see ReplaySignal::WaitAfter
+	 *
+	 * @param Seen Last sequence seen by the caller
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::uint64_t> Sequence of the last fire, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::uint64_t> WaitAfterFor(std::uint64_t Seen, const std::chrono::duration<Representation, Period>& Timeout) {
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(Timeout);
+		return Await(Seen, &Deadline);
+	}
+};
+
+#undef f_
+#endif
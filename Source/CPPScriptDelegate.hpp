@@ -0,0 +1,197 @@
+#ifndef CPPScriptDelegate
+#define CPPScriptDelegate
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "CPPScriptSignal.hpp"
+
+template <typename Signature, std::size_t Capacity = 32, bool Heap = false> class InlineDelegate;
+
+/**
+ * @brief Move-only function stored inside a fixed size buffer
+ *
+ * Unlike `std::function`, the callable is never allocated in the heap,
+ * unless Heap is `true` and it is larger than Capacity (a callable
+ * that doesn't fit without Heap is a compile error). Calling the
+ * delegate is a single indirect call through InlineDelegate::Invoke
+ *
+ * @tparam Arguments The arguments of the callable
+ * @tparam Capacity Size in bytes of the inline buffer
+ * @tparam Heap Allow callables larger than Capacity to be allocated
+ */
+template <typename... Arguments, std::size_t Capacity, bool Heap> class InlineDelegate<void(Arguments...), Capacity, Heap> {
+protected:
+	/**
+	 * @brief Buffer holding the callable (or a pointer to it, in the heap)
+	 *
+	 * @see InlineDelegate::InlineDelegate
+	 */
+	alignas(std::max_align_t) unsigned char Storage[Capacity];
+
+	/**
+	 * @brief Call the callable held in a buffer
+	 *
+	 * @see InlineDelegate::operator()
+	 */
+	void (*Invoke)(void*, Arguments...) = nullptr;
+
+	/**
+	 * @brief Move the callable from the second buffer into the first and destroy it
+	 *
+	 * If the first buffer is `nullptr`, the callable is only destroyed
+	 *
+	 * @see InlineDelegate::~InlineDelegate
+	 */
+	void (*Manage)(void*, void*) = nullptr;
+
+	/**
+	 * @brief If a callable type can be held inside InlineDelegate::Storage
+	 *
+	 * @note The callable must not throw when moved, as the delegate
+	 * moves it together with the buffer
+	 */
+	template <typename Callable> static constexpr bool Fits = sizeof(Callable) <= Capacity
+		&& alignof(Callable) <= alignof(std::max_align_t)
+		&& std::is_nothrow_move_constructible_v<Callable>;
+
+	/** Destroy the held callable, if any */
+	void Reset() {
+		if (Manage) {
+			Manage(nullptr, Storage);
+			Invoke = nullptr;
+			Manage = nullptr;
+		}
+	}
+
+public:
+	static_assert(Capacity >= sizeof(void*), "Capacity must hold at least a pointer");
+
+	/** Construct an empty delegate */
+	InlineDelegate() = default;
+
+	/**
+	 * @brief Construct the delegate holding a callable
+	 *
+	 * @param Function Function or lambda to be held
+	 */
+	template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, InlineDelegate>>>
+	InlineDelegate(Callable&& Function) {
+		using Type = std::decay_t<Callable>;
+
+		if constexpr (Fits<Type>) {
+			new (Storage) Type(std::forward<Callable>(Function));
+
+			Invoke = [](void* Target, Arguments... Values) {
+				(*static_cast<Type*>(Target))(std::forward<Arguments>(Values)...);
+			};
+
+			Manage = [](void* Target, void* Source) {
+				Type* From = static_cast<Type*>(Source);
+
+				if (Target) {
+					new (Target) Type(std::move(*From));
+				}
+
+				From->~Type();
+			};
+		} else if constexpr (Heap) {
+			new (Storage) Type*(new Type(std::forward<Callable>(Function)));
+
+			Invoke = [](void* Target, Arguments... Values) {
+				(**static_cast<Type**>(Target))(std::forward<Arguments>(Values)...);
+			};
+
+			Manage = [](void* Target, void* Source) {
+				Type* From = *static_cast<Type**>(Source);
+
+				if (Target) {
+					new (Target) Type*(From);
+				} else {
+					delete From;
+				}
+			};
+		} else {
+			static_assert(sizeof(Type) == 0, "Callable doesn't fit in the delegate's Capacity, increase it or enable Heap");
+		}
+	}
+
+	/**
+	 * @brief Move the callable of another delegate, that is left empty
+	 *
+	 * @param Other Delegate to be moved
+	 */
+	InlineDelegate(InlineDelegate&& Other) noexcept : Invoke(Other.Invoke), Manage(Other.Manage) {
+		if (Manage) {
+			Manage(Storage, Other.Storage);
+			Other.Invoke = nullptr;
+			Other.Manage = nullptr;
+		}
+	}
+
+	/**
+	 * @brief Destroy the held callable and move the callable of another delegate
+	 *
+	 * @param Other Delegate to be moved
+	 *
+	 * @return InlineDelegate&
+	 */
+	InlineDelegate& operator=(InlineDelegate&& Other) noexcept {
+		if (this != &Other) {
+			Reset();
+
+			if (Other.Manage) {
+				Other.Manage(Storage, Other.Storage);
+				Invoke = Other.Invoke;
+				Manage = Other.Manage;
+				Other.Invoke = nullptr;
+				Other.Manage = nullptr;
+			}
+		}
+
+		return *this;
+	}
+
+	InlineDelegate(const InlineDelegate&) = delete;
+	InlineDelegate& operator=(const InlineDelegate&) = delete;
+
+	/** Destroy the held callable */
+	~InlineDelegate() {
+		Reset();
+	}
+
+	/**
+	 * @brief Call the held callable
+	 *
+	 * @note Calling an empty delegate is undefined
+	 *
+	 * @param Values Arguments to the callable
+	 */
+	inline void operator()(Arguments... Values) const {
+		Invoke(const_cast<unsigned char*>(Storage), std::forward<Arguments>(Values)...);
+	}
+
+	/**
+	 * @brief Return if the delegate holds a callable
+	 *
+	 * @return `true` if it is not empty
+	 */
+	explicit operator bool() const {
+		return Invoke != nullptr;
+	}
+};
+
+/**
+ * @brief Class of signal holding each connection's function in an InlineDelegate
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class InlineSignal : public BasicScriptSignal<InlineDelegate<void(ScriptArgument<Parameters>...)>, Parameters...> {
+public:
+	/** Construct the signal, with a name or without */
+	using BasicScriptSignal<InlineDelegate<void(ScriptArgument<Parameters>...)>, Parameters...>::BasicScriptSignal;
+};
+
+#endif
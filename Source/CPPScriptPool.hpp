@@ -0,0 +1,249 @@
+#ifndef CPPScriptPool
+#define CPPScriptPool
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Class of a fixed pool of worker threads
+ *
+ * Used as the executor of ScriptSignalBase::FireParallel and
+ * ScriptSignalBase::FireAsync, but any task can be posted to it
+ */
+class ScriptPool {
+protected:
+	/**
+	 * @brief State of a ScriptPool::Parallel call shared with its helpers
+	 *
+	 * Chunks are claimed from a shared cursor, so a worker that finishes
+	 * early keeps taking the remaining chunks from the slower ones
+	 *
+	 * @tparam Body Type of the function called for each chunk
+	 */
+	template <typename Body> struct Batch {
+		/** Function called for each chunk */
+		const Body& Work;
+
+		/** Number of items */
+		std::size_t Count;
+
+		/** Number of items in each chunk */
+		std::size_t Chunk;
+
+		/** Number of chunks */
+		std::size_t Chunks;
+
+		/** First item of the next chunk to be claimed */
+		std::atomic<std::size_t> Cursor{0};
+
+		/** Number of chunks already done */
+		std::atomic<std::size_t> Completed{0};
+
+		/** Access synchronization for Completed while waiting */
+		std::mutex Current;
+
+		/** Wakes the caller of ScriptPool::Parallel when all chunks are done */
+		std::condition_variable Condition;
+
+		/**
+		 * @brief Construct the state of a parallel call
+		 *
+		 * @param Function Function called for each chunk
+		 * @param Items Number of items
+		 * @param Size Number of items in each chunk
+		 */
+		Batch(const Body& Function, std::size_t Items, std::size_t Size)
+			: Work(Function), Count(Items), Chunk(Size), Chunks((Items + Size - 1) / Size) {}
+
+		/**
+		 * @brief Claim and run chunks until none is left
+		 *
+		 * @note Work is only touched while a chunk is claimed, so a helper
+		 * that starts after the call returned exits without using it
+		 */
+		void Run() {
+			for (;;) {
+				const std::size_t Begin = Cursor.fetch_add(Chunk);
+
+				if (Begin >= Count) {
+					return;
+				}
+
+				Work(Begin, std::min(Begin + Chunk, Count));
+
+				if (Completed.fetch_add(1) + 1 == Chunks) {
+					std::lock_guard<std::mutex> Hold(Current);
+					Condition.notify_all();
+				}
+			}
+		}
+	};
+
+	/**
+	 * @brief Threads running ScriptPool::Run
+	 *
+	 * @see ScriptPool::ScriptPool
+	 */
+	std::vector<std::thread> Workers;
+
+	/**
+	 * @brief Tasks posted and not yet taken by a worker
+	 *
+	 * @see ScriptPool::Post
+	 */
+	std::deque<f_(void)> Tasks;
+
+	/**
+	 * @brief Access synchronization for Tasks and Stopping
+	 *
+	 * @see ScriptPool::Post
+	 * @see ScriptPool::Run
+	 */
+	std::mutex Current;
+
+	/**
+	 * @brief Wakes the workers when a task is posted
+	 *
+	 * @see ScriptPool::Post
+	 * @see ScriptPool::Run
+	 */
+	std::condition_variable Condition;
+
+	/**
+	 * @brief If the pool is being deconstructed
+	 *
+	 * @see ScriptPool::~ScriptPool
+	 */
+	bool Stopping = false;
+
+	/**
+	 * @brief Take and run tasks until the pool is stopped
+	 *
+	 * @note Tasks left when the pool is stopped are still run
+	 */
+	void Run() {
+		for (;;) {
+			f_(void) Task;
+
+			{
+				std::unique_lock Lock(Current);
+				Condition.wait(Lock, [this] { return Stopping || !Tasks.empty(); });
+
+				if (Tasks.empty()) {
+					return;
+				}
+
+				Task = std::move(Tasks.front());
+				Tasks.pop_front();
+			}
+
+			Task();
+		}
+	}
+
+public:
+	/**
+	 * @brief Start the worker threads
+	 *
+	 * @param Count Number of workers, at least one
+	 */
+	explicit ScriptPool(std::size_t Count = std::thread::hardware_concurrency()) {
+		Count = std::max<std::size_t>(Count, 1);
+		Workers.reserve(Count);
+
+		for (std::size_t Index = 0; Index < Count; ++Index) {
+			Workers.emplace_back([this] { Run(); });
+		}
+	}
+
+	/** Run the tasks left, stop and join all workers */
+	~ScriptPool() {
+		{
+			std::lock_guard<std::mutex> Hold(Current);
+			Stopping = true;
+		}
+
+		Condition.notify_all();
+		for (auto& Worker : Workers) {
+			Worker.join();
+		}
+	}
+
+	ScriptPool(const ScriptPool&) = delete;
+	ScriptPool& operator=(const ScriptPool&) = delete;
+
+	/**
+	 * @brief Return the number of worker threads
+	 *
+	 * @return std::size_t
+	 */
+	inline std::size_t Size() const {
+		return Workers.size();
+	}
+
+	/**
+	 * @brief Post a task to be run by a worker
+	 *
+	 * @param Task Function or lambda to be run
+	 */
+	void Post(f_(void) Task) {
+		{
+			std::lock_guard<std::mutex> Hold(Current);
+			Tasks.push_back(std::move(Task));
+		}
+
+		Condition.notify_one();
+	}
+
+	/**
+	 * @brief Call a function over chunks of a range and wait all of them
+	 *
+	 * Items `[0, Count)` are split in chunks of Chunk items, that are
+	 * claimed by the calling thread and by up to one helper per worker.
+	 * Returns after every chunk is done
+	 *
+	 * @note The calling thread works too, so calling it from inside a
+	 * task never waits for a helper that has no worker to run it
+	 *
+	 * @param Count Number of items
+	 * @param Chunk Number of items given to a thread at once
+	 * @param Work Function called as `Work(Begin, End)` for each chunk
+	 */
+	template <typename Body> void Parallel(std::size_t Count, std::size_t Chunk, const Body& Work) {
+		Chunk = std::max<std::size_t>(Chunk, 1);
+
+		if (Count <= Chunk) {
+			if (Count != 0) {
+				Work(0, Count);
+			}
+
+			return;
+		}
+
+		auto Shared = std::make_shared<Batch<Body>>(Work, Count, Chunk);
+		const std::size_t Helpers = std::min(Workers.size(), Shared->Chunks - 1);
+
+		for (std::size_t Index = 0; Index < Helpers; ++Index) {
+			Post([Shared] { Shared->Run(); });
+		}
+
+		Shared->Run();
+
+		std::unique_lock Lock(Shared->Current);
+		Shared->Condition.wait(Lock, [&Shared] { return Shared->Completed.load() == Shared->Chunks; });
+	}
+};
+
+#undef f_
+#endif
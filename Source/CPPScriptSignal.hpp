@@ -1,217 +1,2704 @@
 #ifndef CPPScriptSignal
 #define CPPScriptSignal
 
-#include <mutex>
+#include <tuple>
+#include <atomic>
+#include <memory>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <utility>
+#include <optional>
+#include <coroutine>
+#include <algorithm>
 #include <functional>
-#include <condition_variable>
+#include <unordered_map>
+#include <type_traits>
+
+#ifdef CPPScriptSignalMetrics
+#include <bit>
+#include <array>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
 
 /** Alias for the default function type to be used */
 #define f_(X) std::function<void(X)>
 
 /**
- * @brief Class of signal
+ * @brief Type used to pass a parameter to each connection's function
  *
- * @tparam Parameters The parameters to be used in function of connection
+ * Values are passed by const reference, so firing a signal never
+ * copies its arguments, while reference parameters are kept as they are
+ *
+ * @tparam Type The parameter of the signal
  */
-template <typename... Parameters> class ScriptSignal {
-protected:
-	/** Struct of connection */
-	struct Connection {
-	protected:
-		/**
-		 * @brief Function to erase the connection's function
-		 *
-		 * @see ScriptSignal::Connection::Connection
-		 */
-		f_(void) Destroy;
+template <typename Type> using ScriptArgument = std::conditional_t<std::is_reference_v<Type>, Type, const Type&>;
 
-		/**
-		 * @brief Hold if connection's function still exists
-		 *
-		 * @see ScriptSignal::Connection::Connected
-		 * @see ScriptSignal::Connection::Disconnect
-		 */
-		bool isConnected = true;
+#ifdef CPPScriptSignalMetrics
+/**
+ * @brief Struct of the calls measured for a connection's function
+ *
+ * Only compiled when `CPPScriptSignalMetrics` is defined before including
+ * the library, otherwise signals hold and measure nothing
+ *
+ * @see ScriptSignalBase::Metrics
+ */
+struct ScriptMetrics {
+	/** Number of calls */
+	std::uint64_t Calls = 0;
 
-	public:
-		/**
-		 * @brief Constructor of connection to direct initialize Destroy function
-		 *
-		 * The Destroy function is used to call a out-scope member
-		 * ScriptSignal::Functions to erase the function that
-		 * the current connection holds, being initilized by a
-		 * lambda reference that can call this member
-		 *
-		 * @see ScriptSignal::Connect
-		 *
-		 * @param Function Function or lambda to be used in Destroy
-		 */
-	 	Connection(const f_(void)& Function) : Destroy(Function) {}
+	/** Time spent in all calls */
+	std::chrono::nanoseconds Total{0};
 
-	 	/**
-	 	 * @brief Return if connection's function exists or not
-		 *
-		 * @return ScriptSignal::Connection::isConnected
-		 */
-		inline bool Connected() {
-			return isConnected;
+	/** Time spent in the longest call */
+	std::chrono::nanoseconds Longest{0};
+
+	/** Number of calls that took `[2^(N-1), 2^N)` nanoseconds for each N, the last one holds all longer calls */
+	std::array<std::uint64_t, 32> Histogram{};
+
+	/**
+	 * @brief Add a call
+	 *
+	 * @param Elapsed Time spent in the call
+	 */
+	void Record(std::chrono::nanoseconds Elapsed) {
+		const auto Count = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(Elapsed.count(), 0));
+
+		++Calls;
+		Total += Elapsed;
+		Longest = std::max(Longest, Elapsed);
+		++Histogram[std::min<std::size_t>(std::bit_width(Count), Histogram.size() - 1)];
+	}
+};
+#endif
+
+/**
+ * @brief Struct of the hooks called around fires and function calls
+ *
+ * Installed for every signal through ScriptTracing, as ScriptTrace does
+ *
+ * @see ScriptTracing
+ */
+struct ScriptTracer {
+	/** Listener passed to the hooks for the whole fire of a signal */
+	static constexpr std::size_t Dispatch = static_cast<std::size_t>(-1);
+
+	/** Called before a fire or a function call, with the signal, its name (or `nullptr`) and the connection's slot */
+	void (*Begin)(const void* Signal, const char* Name, std::size_t Listener);
+
+	/** Called after a fire or a function call, with the same arguments as Begin */
+	void (*End)(const void* Signal, const char* Name, std::size_t Listener);
+};
+
+/**
+ * @brief Hooks currently called by all signals, `nullptr` when tracing is off
+ *
+ * @note While tracing is off, each fire and each function call only
+ * loads this pointer and takes a predictable branch
+ */
+inline std::atomic<const ScriptTracer*> ScriptTracing{nullptr};
+
+/**
+ * @brief Calls the tracing hooks around a scope, if tracing is on
+ *
+ * @see ScriptTracing
+ */
+struct ScriptTraceScope {
+	/** Hooks loaded when the scope began */
+	const ScriptTracer* Tracer;
+
+	/** Signal being traced */
+	const void* Signal;
+
+	/** Name of the signal */
+	const char* Name;
+
+	/** Slot of the function being called or ScriptTracer::Dispatch */
+	std::size_t Listener;
+
+	/**
+	 * @brief Call ScriptTracer::Begin, if tracing is on
+	 *
+	 * @param Owner Signal being traced
+	 * @param Label Name of the signal
+	 * @param Index Slot of the function being called or ScriptTracer::Dispatch
+	 */
+	ScriptTraceScope(const void* Owner, const char* Label, std::size_t Index)
+		: Tracer(ScriptTracing.load(std::memory_order_acquire)), Signal(Owner), Name(Label), Listener(Index) {
+		if (Tracer) [[unlikely]] {
+			Tracer->Begin(Signal, Name, Listener);
 		}
+	}
 
-		/**
-		 * @brief Call Destroy and set isConnected to `false`
-		 *
-		 * After Destroy is called, the connection's function
-		 * is erased and isConnected is set to `false`
-		 *
-		 * @note The function verify if isConnected is `true`
-		 * before calling Destroy and change isConnected
-		 *
-		 * @see ScriptSignal::Connection::Destroy
-		 * @see ScriptSignal::Connection::isConnected
-		 */
-		void Disconnect() {
-			if (isConnected) {
-				Destroy();
-				isConnected = false;
-			}
+	/** Call ScriptTracer::End, if ScriptTracer::Begin was called */
+	~ScriptTraceScope() {
+		if (Tracer) [[unlikely]] {
+			Tracer->End(Signal, Name, Listener);
 		}
-	};
+	}
+};
+
+/**
+ * @brief Class of the waiting machinery shared by all signals
+ *
+ * Each fire advances an atomic generation, a waiter captures the
+ * generation and blocks until it changes. A waiter first spins for a
+ * short while, then parks on the generation itself (a futex on Linux,
+ * `std::atomic::wait` elsewhere), and firing only makes the wake up
+ * call when some thread is parked
+ */
+class ScriptWaiter {
+protected:
+	/** Clock used to measure and limit waits */
+	using Clock = std::chrono::steady_clock;
 
 	/**
-	 * @brief Manage the block of a thread by conditional statement
+	 * @brief Number of fires notified, the word waiters park on
 	 *
-	 * @see ScriptSignal::Fire
-	 * @see ScriptSignal::Wait
+	 * @see ScriptWaiter::Notify
+	 * @see ScriptWaiter::Park
 	 */
-	std::condition_variable Condition;
+	std::atomic<std::uint32_t> Generation{0};
 
 	/**
-	 * @brief A vector of all connections function
+	 * @brief Number of threads parked, or about to park
 	 *
-	 * @see ScriptSignal::Connect
-	 * @see ScriptSignal::Fire
+	 * @see ScriptWaiter::Notify
 	 */
-	std::vector<f_(Parameters...)> Functions;
+	std::atomic<std::uint32_t> Waiters{0};
 
 	/**
-	 * @brief A vector of all connections
-	 *
-	 * @see ScriptSignal::~ScriptSignal
-	 * @see ScriptSignal::Connect
+	 * @brief Times the generation is checked before parking
 	 *
+	 * @see ScriptWaiter::Spin
 	 */
-	std::vector<Connection*> Connections;
+	std::uint32_t Spins = 128;
+
+	/** Hint the processor that the thread is spinning */
+	static inline void Relax() {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		asm volatile("yield");
+#endif
+	}
 
 	/**
-	 * @brief Access synchronization for Idle
+	 * @brief Block the thread while the generation is Seen, or until Deadline
+	 *
+	 * May return spuriously, the caller checks the generation again
+	 *
+	 * @note Only Linux blocks with a timeout, elsewhere a wait with a
+	 * deadline sleeps in short steps, as `std::atomic::wait` has no timeout
 	 *
-	 * @see ScriptSignal::Fire
-	 * @see ScriptSignal::Wait
+	 * @param Seen Generation captured by the waiter
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
 	 */
-	std::mutex Current;
+	void Park(std::uint32_t Seen, const Clock::time_point* Deadline) {
+#if defined(__linux__)
+		timespec Timeout;
+		timespec* Limit = nullptr;
+
+		if (Deadline) {
+			const auto Left = std::chrono::duration_cast<std::chrono::nanoseconds>(*Deadline - Clock::now()).count();
+
+			if (Left <= 0) {
+				return;
+			}
+
+			Timeout.tv_sec = static_cast<time_t>(Left / 1000000000);
+			Timeout.tv_nsec = static_cast<long>(Left % 1000000000);
+			Limit = &Timeout;
+		}
+
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Generation), FUTEX_WAIT_PRIVATE, Seen, Limit, nullptr, 0);
+#else
+		if (Deadline) {
+			std::this_thread::sleep_for(std::min<Clock::duration>(std::chrono::microseconds(50), *Deadline - Clock::now()));
+		} else {
+			Generation.wait(Seen);
+		}
+#endif
+	}
+
+	/** Wake all threads parked on the generation */
+	void Unpark() {
+#if defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Generation), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+		Generation.notify_all();
+#endif
+	}
 
 	/**
-	 * @brief Thread blocking condition
+	 * @brief Wait for the generation to leave Seen, or until Deadline
 	 *
-	 * @see ScriptSignal::Fire
-	 * @see ScriptSignal::Wait
+	 * @note The waiter is counted before the last check of the
+	 * generation, and ScriptWaiter::Notify advances it before reading
+	 * Waiters, so either the fire sees the waiter or the waiter sees the fire
+	 *
+	 * @param Seen Generation captured by the waiter
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
+	 *
+	 * @return `true` if the generation changed
 	 */
-	bool Idle = false;
+	bool Block(std::uint32_t Seen, const Clock::time_point* Deadline) {
+		for (std::uint32_t Count = 0; Count < Spins; ++Count) {
+			if (Generation.load(std::memory_order_acquire) != Seen) {
+				return true;
+			}
+
+			Relax();
+		}
+
+		Waiters.fetch_add(1);
+		bool Fired = false;
+
+		while (!(Fired = Generation.load() != Seen)) {
+			if (Deadline && Clock::now() >= *Deadline) {
+				break;
+			}
+
+			Park(Seen, Deadline);
+		}
+
+		Waiters.fetch_sub(1);
+		return Fired;
+	}
 
 public:
 	/**
-	 * @brief Delete all connections and deconstruct Signal
+	 * @brief Return the number of fires notified
+	 *
+	 * @note The counter wraps around
+	 *
+	 * @return std::uint32_t
+	 */
+	inline std::uint32_t Fires() const {
+		return Generation.load();
+	}
+
+	/**
+	 * @brief Set how many times a waiter checks for a fire before parking
 	 *
-	 * As connections are pointers pointing to objects, which can also be
-	 * independent of the constructor scope, it is necessary to group them
-	 * into an vector, and use it to deallocate all existing connections
-	 * when the Signal is deconstructed
+	 * @param Count Times to spin, `0` parks right away
+	 */
+	void Spin(std::uint32_t Count) {
+		Spins = Count;
+	}
+
+	/**
+	 * @brief Advance the generation and wake the parked threads
 	 *
-	 * @see ScriptSignal::Connections
+	 * @note The wake up call is skipped when no thread is parked
 	 */
-	virtual ~ScriptSignal() {
-		for (const auto& Connection : Connections) {
-			delete Connection;
+	void Notify() {
+		Generation.fetch_add(1);
+
+		if (Waiters.load() != 0) {
+			Unpark();
 		}
 	}
 
 	/**
-	 * @brief Create a new connection and it's function
+	 * @brief Wait for a condition made true before a ScriptWaiter::Notify, or until Deadline
 	 *
-	 * Creates a pointer to a new connection struct and push back the
-	 * connection's function in ScriptSignal::Functions vector.
-	 * The connection is constructed with a referenced lambda
-	 * that can call ScriptSignal::Functions to after erase
-	 * the current connection's function
+	 * The generation is captured before each check of the condition, so
+	 * a condition made true and notified after the check always ends the block
+	 *
+	 * @param Ready Condition checked, made true with release order then notified
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
+	 *
+	 * @return `true` if the condition became true
+	 */
+	template <typename Condition> bool WaitReady(Condition Ready, const std::chrono::steady_clock::time_point* Deadline) {
+		for (;;) {
+			const std::uint32_t Seen = Generation.load();
+
+			if (Ready()) {
+				return true;
+			}
+
+			if (!Block(Seen, Deadline)) {
+				return Ready();
+			}
+		}
+	}
+
+	/**
+	 * @brief Wait for the next ScriptWaiter::Notify and return elapsed time
 	 *
-	 * @see ScriptSignal::Connection:Connection
+	 * @return std::chrono::nanoseconds Elapsed time
+	 */
+	std::chrono::nanoseconds Wait() {
+		const Clock::time_point Time = Clock::now();
+		Block(Generation.load(), nullptr);
+		return Clock::now() - Time;
+	}
+
+	/**
+	 * @brief Wait for the next ScriptWaiter::Notify until a time point
 	 *
-	 * @param Function Function or lambda to be used in connection
+	 * @param Time Time point to stop waiting, in any clock
 	 *
-	 * @return ScriptSignal::Connection*
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
 	 */
-	virtual Connection* Connect(const f_(Parameters...)& Function) {
-		Connection* New = new Connection([this, Index = Functions.size()] {
-			Functions.erase(Functions.begin() + Index);
-		});
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		const Clock::time_point Start = Clock::now();
+		const Clock::time_point Deadline = Start + std::chrono::duration_cast<Clock::duration>(Time - Source::now());
 
-		Functions.push_back(Function);
-		Connections.push_back(New);
-		return New;
+		if (!Block(Generation.load(), &Deadline)) {
+			return std::nullopt;
+		}
+
+		return Clock::now() - Start;
 	}
 
 	/**
-	 * @brief Call all functions in ScriptSignal::Functions vector
+	 * @brief Wait for the next ScriptWaiter::Notify for a duration
 	 *
-	 * If `Functions.empty()` is `false`, the function calls all
-	 * ScriptSignal::Functions with the given arguments in base of
-	 * the parameters created in Signal construct
+	 * @param Timeout Longest time to wait
 	 *
-	 * @note Holds mutex and set Idle to `true`, and notify all
-	 * ScriptSignal::Wait waiting for ScriptSignal::Fire to be
-	 * called, by ScriptSignal::Condition
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return WaitUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(Timeout));
+	}
+};
+
+/**
+ * @brief Base class of all signals, without virtual methods
+ *
+ * Derived is the most derived class (CRTP), that may customize the
+ * signal by declaring its own hooks, ScriptSignalBase::OnFirstConnect
+ * and ScriptSignalBase::OnLastDisconnect, called without virtual
+ * dispatch. The hooks must be accessible from this class
+ *
+ * The function type is what ScriptSignalBase::Functions holds, it must be
+ * movable and callable with the signal's parameters as ScriptArgument,
+ * like `std::function` or InlineDelegate (see CPPScriptDelegate.hpp)
+ *
+ * @tparam Derived The class deriving from this one
+ * @tparam Function The type used to hold the function of each connection
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename Derived, typename Function, typename... Parameters> class ScriptSignalBase {
+public:
+	/**
+	 * @brief Struct of connection
 	 *
-	 * @see ScriptSignal::Current
-	 * @see ScriptSignal::Idle
+	 * A connection is a small handle to the slot of its function, so it
+	 * is returned by value and can be freely copied. The slot itself is
+	 * recycled by the signal after ScriptSignalBase::Connection::Disconnect
+	 */
+	struct Connection {
+	protected:
+		friend ScriptSignalBase;
+
+		/**
+		 * @brief Signal that owns the connection's function
+		 *
+		 * @see ScriptSignalBase::Connection::Connection
+		 */
+		ScriptSignalBase* Signal = nullptr;
+
+		/**
+		 * @brief Index of the connection's slot in ScriptSignalBase::Slots
+		 *
+		 * @see ScriptSignalBase::Slots
+		 */
+		std::size_t Index = 0;
+
+		/**
+		 * @brief Generation of the slot when the connection was created
+		 *
+		 * The slot's generation is increased when its function is erased,
+		 * so a connection holding an older generation is known to be stale
+		 *
+		 * @see ScriptSignalBase::Slot::Generation
+		 */
+		std::uint32_t Generation = 0;
+
+	public:
+		/** Construct a connection that isn't connected to any signal */
+		Connection() = default;
+
+		/**
+		 * @brief Constructor of connection to direct initialize its handle
+		 *
+		 * The handle (slot index and generation) is used to find the
+		 * function that the current connection holds in the out-scope
+		 * member ScriptSignalBase::Functions, without depending on the
+		 * position of the function in it
+		 *
+		 * @see ScriptSignalBase::Connect
+		 *
+		 * @param Owner Signal that holds the connection's function
+		 * @param Slot Index of the slot in ScriptSignalBase::Slots
+		 * @param Current Generation of the slot
+		 */
+	 	Connection(ScriptSignalBase* Owner, std::size_t Slot, std::uint32_t Current) : Signal(Owner), Index(Slot), Generation(Current) {}
+
+	 	/**
+	 	 * @brief Return if connection's function exists or not
+		 *
+		 * @return `true` if the slot's generation still matches the connection's
+		 */
+		inline bool Connected() const {
+			return Signal && Signal->Slots[Index].Generation == Generation;
+		}
+
+		/**
+		 * @brief Erase the connection's function from the signal
+		 *
+		 * After disconnected, the slot's generation changes and
+		 * ScriptSignalBase::Connection::Connected returns `false`
+		 *
+		 * @note Calling it on a stale connection does nothing
+		 *
+		 * @see ScriptSignalBase::Erase
+		 */
+		void Disconnect() {
+			if (Signal) {
+				Signal->Erase(Index, Generation);
+			}
+		}
+	};
+
+	/**
+	 * @brief Move-only connection that disconnects when deconstructed
 	 *
-	 * @param Arguments Arguments in base of Signal's parameters
+	 * @see ScriptSignalBase::Connection
 	 */
-	virtual void Fire(Parameters... Arguments) {
-		if (Functions.empty()) {
-			return;
+	struct ScopedConnection {
+	protected:
+		/**
+		 * @brief The connection to be disconnected
+		 *
+		 * @see ScriptSignalBase::ScopedConnection::~ScopedConnection
+		 */
+		Connection Held;
+
+	public:
+		/** Construct a scoped connection that holds nothing */
+		ScopedConnection() = default;
+
+		/**
+		 * @brief Take the ownership of a connection
+		 *
+		 * @param Target Connection returned by ScriptSignalBase::Connect
+		 */
+		ScopedConnection(const Connection& Target) : Held(Target) {}
+
+		/**
+		 * @brief Take the connection of another scoped connection
+		 *
+		 * @param Other Scoped connection left holding nothing
+		 */
+		ScopedConnection(ScopedConnection&& Other) noexcept : Held(Other.Release()) {}
+
+		/**
+		 * @brief Disconnect the held connection and take the one of another
+		 *
+		 * @param Other Scoped connection left holding nothing
+		 *
+		 * @return ScriptSignalBase::ScopedConnection&
+		 */
+		ScopedConnection& operator=(ScopedConnection&& Other) noexcept {
+			if (this != &Other) {
+				Held.Disconnect();
+				Held = Other.Release();
+			}
+
+			return *this;
 		}
 
-		for (const auto& Function : Functions) {
-			Function(Arguments...);
+		ScopedConnection(const ScopedConnection&) = delete;
+		ScopedConnection& operator=(const ScopedConnection&) = delete;
+
+		/** Disconnect the held connection */
+		~ScopedConnection() {
+			Held.Disconnect();
 		}
 
-		std::lock_guard<std::mutex> Hold(Current);
-		Idle = true; Condition.notify_all();
-	}
+		/**
+		 * @brief Return if the held connection's function exists or not
+		 *
+		 * @see ScriptSignalBase::Connection::Connected
+		 */
+		inline bool Connected() const {
+			return Held.Connected();
+		}
+
+		/**
+		 * @brief Disconnect the held connection now
+		 *
+		 * @see ScriptSignalBase::Connection::Disconnect
+		 */
+		void Disconnect() {
+			Held.Disconnect();
+		}
+
+		/**
+		 * @brief Stop holding the connection without disconnecting it
+		 *
+		 * @return ScriptSignalBase::Connection The released connection
+		 */
+		Connection Release() {
+			Connection Released = Held;
+			Held = Connection();
+			return Released;
+		}
+	};
 
 	/**
-	 * @brief Wait for ScriptSignal::Fire to be called and return elapsed time
-	 *
-	 * Sets Idle to `false`, creates a new steady clock for duration, locks
-	 * mutex, and waits for Idle to be `true` (that is done by ScriptSignal::Fire)
-	 * and return the duration holded by the steady clock
+	 * @brief Move-only set of connections disconnected all at once
 	 *
-	 * @see ScriptSignal::Current
-	 * @see ScriptSignal::Idle
+	 * A level connects its listeners in a group and disconnects the
+	 * whole group when it unloads: the functions are marked Dead, then
+	 * each signal is compacted a single time, instead of one removal
+	 * per connection
 	 *
-	 * @return long long Elapsed time to wait for ScriptSignal::Fire to be called
+	 * @see ScriptSignalBase::ConnectMany
+	 * @see ScriptSignalBase::Sweep
 	 */
-	long long Wait() {
-		Idle = false;
-		using Clock = std::chrono::steady_clock;
-		Clock::time_point Time = Clock::now();
-		std::unique_lock Lock(Current);
-		Condition.wait(Lock, [this] { return Idle; });
-		return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - Time).count();
-	}
+	struct ConnectionGroup {
+	protected:
+		/**
+		 * @brief The connections to be disconnected
+		 *
+		 * @see ScriptSignalBase::ConnectionGroup::Disconnect
+		 */
+		std::vector<Connection> Members;
+
+	public:
+		/** Construct an empty group */
+		ConnectionGroup() = default;
+
+		/**
+		 * @brief Take the connections of another group
+		 *
+		 * @param Other Group left empty
+		 */
+		ConnectionGroup(ConnectionGroup&& Other) noexcept : Members(std::move(Other.Members)) {
+			Other.Members.clear();
+		}
+
+		/**
+		 * @brief Disconnect the held connections and take the ones of another group
+		 *
+		 * @param Other Group left empty
+		 *
+		 * @return ScriptSignalBase::ConnectionGroup&
+		 */
+		ConnectionGroup& operator=(ConnectionGroup&& Other) noexcept {
+			if (this != &Other) {
+				Disconnect();
+				Members = std::move(Other.Members);
+				Other.Members.clear();
+			}
+
+			return *this;
+		}
+
+		ConnectionGroup(const ConnectionGroup&) = delete;
+		ConnectionGroup& operator=(const ConnectionGroup&) = delete;
+
+		/** Disconnect the held connections */
+		~ConnectionGroup() {
+			Disconnect();
+		}
+
+		/**
+		 * @brief Add a connection of any signal of the same type to the group
+		 *
+		 * @param Member Connection returned by ScriptSignalBase::Connect
+		 */
+		void Add(const Connection& Member) {
+			Members.push_back(Member);
+		}
+
+		/**
+		 * @brief Reserve room for connections to be added
+		 *
+		 * @param Count Number of connections
+		 */
+		void Reserve(std::size_t Count) {
+			Members.reserve(Count);
+		}
+
+		/**
+		 * @brief Return the number of connections held, connected or not
+		 *
+		 * @return std::size_t
+		 */
+		inline std::size_t Size() const {
+			return Members.size();
+		}
+
+		/**
+		 * @brief Disconnect every held connection, compacting each signal once
+		 *
+		 * @note Stale connections are skipped, and during a fire the
+		 * compaction is left to the outermost fire as for ScriptSignalBase::Erase
+		 *
+		 * @see ScriptSignalBase::Sweep
+		 */
+		void Disconnect() {
+			Sweep(Members);
+			Members.clear();
+		}
+	};
+
+protected:
+	/** Shared state of a fire made by ScriptSignalBase::FireAsync */
+	struct Pending;
+
+public:
+	/**
+	 * @brief Completion handle of a fire made by ScriptSignalBase::FireAsync
+	 *
+	 * Holds the only allocation of the asynchronous fire, shared with
+	 * the posted task: the copied arguments and a completion flag
+	 */
+	struct Ticket {
+	protected:
+		/**
+		 * @brief State of the fire
+		 *
+		 * @see ScriptSignalBase::Pending
+		 */
+		std::shared_ptr<Pending> State;
+
+	public:
+		/** Construct a ticket of no fire, that is always done */
+		Ticket() = default;
+
+		/**
+		 * @brief Construct the ticket of a fire
+		 *
+		 * @param Fire State of the fire
+		 */
+		Ticket(std::shared_ptr<Pending> Fire) : State(std::move(Fire)) {}
+
+		/**
+		 * @brief Return if every function of the fire was called
+		 *
+		 * @return `true` if the fire is done
+		 */
+		inline bool Done() const {
+			return !State || State->Finished.load();
+		}
+
+		/**
+		 * @brief Block the thread until the fire is done
+		 *
+		 * @note The thread waits on the ticket's own flag, so the
+		 * signal isn't touched and may be deconstructed right after
+		 */
+		void Wait() const {
+			if (State) {
+				State->Finished.wait(false);
+			}
+		}
+	};
+
+	/**
+	 * @brief Awaitable of the next fire, returned by `co_await Signal`
+	 *
+	 * @see ScriptSignalBase::operator co_await
+	 */
+	struct Awaiter;
+
+#ifdef CPPScriptSignalMetrics
+	/**
+	 * @brief Struct of the metrics of a signal
+	 *
+	 * @see ScriptSignalBase::Metrics
+	 */
+	struct Report {
+		/** Struct of the metrics of a connection */
+		struct Entry {
+			/** Connection of the measured function */
+			Connection Handle;
+
+			/** Calls of the function */
+			ScriptMetrics Metrics;
+		};
+
+		/** Number of fires that called some function, counting each flushed fire */
+		std::uint64_t Fires = 0;
+
+		/** Time spent dispatching the fires, including fires made by functions */
+		std::chrono::nanoseconds Dispatch{0};
+
+		/** Metrics of each connection, in calling order */
+		std::vector<Entry> Listeners;
+	};
+
+#endif
+protected:
+	/**
+	 * @brief Struct of a slot in ScriptSignalBase::Slots
+	 *
+	 * While the slot is in use, Position is the index of its function in
+	 * ScriptSignalBase::Functions, otherwise it is the next free slot.
+	 * It is ScriptSignalBase::None while the connection is deferred
+	 * until the running fire returns
+	 *
+	 * @see ScriptSignalBase::Free
+	 */
+	struct Slot {
+		/** Index in ScriptSignalBase::Functions, next free slot or ScriptSignalBase::None */
+		std::size_t Position;
+
+		/** Increased each time the slot's function is erased */
+		std::uint32_t Generation;
+	};
+
+	/**
+	 * @brief Struct of a range of functions with the same priority
+	 *
+	 * A bucket starts at the end of the previous one
+	 *
+	 * @see ScriptSignalBase::Buckets
+	 */
+	struct Bucket {
+		/** Priority of the bucket's functions */
+		int Priority;
+
+		/** Position after the bucket's last function in ScriptSignalBase::Functions */
+		std::size_t End;
+	};
+
+	/** Marks the end of the free slots list */
+	static constexpr std::size_t None = static_cast<std::size_t>(-1);
+
+	/** State of a function in ScriptSignalBase::Records */
+	enum : std::uint8_t {
+		/** Called by every fire */
+		Live,
+
+		/** Called by the next fire only, then erased */
+		Once,
+
+		/** Called by every fire while its owner in ScriptSignalBase::Watched is alive */
+		Tracked,
+
+		/** Erased during a fire, skipped until compacted */
+		Dead,
+
+		/** Once function called by ScriptSignalBase::FireParallel, erased when compacted */
+		Spent
+	};
+
+	/**
+	 * @brief Struct of a connection made during a fire
+	 *
+	 * @see ScriptSignalBase::Incoming
+	 */
+	struct Deferred {
+		/** Function of the connection */
+		Function Listener;
+
+		/** Priority of the function */
+		int Priority;
+
+		/** Index of the connection's slot in ScriptSignalBase::Slots */
+		std::size_t Index;
+
+		/** Generation of the slot when connected */
+		std::uint32_t Generation;
+
+		/** Live, Once or Tracked */
+		std::uint8_t State;
+	};
+
+	/**
+	 * @brief Struct of the bookkeeping of a function in ScriptSignalBase::Functions
+	 *
+	 * @see ScriptSignalBase::Records
+	 */
+	struct Record {
+		/** Index of the function's slot in ScriptSignalBase::Slots */
+		std::size_t Index;
+
+		/** Live, Once, Tracked, Dead or Spent */
+		std::uint8_t State;
+	};
+
+	/**
+	 * @brief Struct of a signal fired by this one
+	 *
+	 * @see ScriptSignalBase::Forward
+	 */
+	struct Link {
+		/** Signal to be fired, `nullptr` once unlinked during a fire */
+		void* Target;
+
+		/** Fire the target with the arguments of this signal's fire */
+		void (*Dispatch)(void*, ScriptArgument<Parameters>...);
+	};
+
+	/**
+	 * @brief A dense vector of all connections function
+	 *
+	 * @note Erasing moves the following functions back into the erased
+	 * position, so the vector is always contiguous and in connection
+	 * order inside each bucket. During a fire nothing moves:
+	 * erased functions are only marked Dead and new ones are deferred,
+	 * until the outermost fire returns and ScriptSignalBase::Compact runs
+	 *
+	 * @see ScriptSignalBase::Connect
+	 * @see ScriptSignalBase::Erase
+	 * @see ScriptSignalBase::Fire
+	 */
+	std::vector<Function> Functions;
+
+	/**
+	 * @brief Buckets of ScriptSignalBase::Functions, from the highest priority
+	 *
+	 * @see ScriptSignalBase::Connect
+	 */
+	std::vector<Bucket> Buckets;
+
+	/**
+	 * @brief The slot and state of each function in ScriptSignalBase::Functions
+	 *
+	 * @see ScriptSignalBase::Erase
+	 * @see ScriptSignalBase::Call
+	 */
+	std::vector<Record> Records;
+
+	/**
+	 * @brief A vector of all slots, used and free
+	 *
+	 * @see ScriptSignalBase::Slot
+	 */
+	std::vector<Slot> Slots;
+
+	/**
+	 * @brief First free slot in ScriptSignalBase::Slots
+	 *
+	 * @see ScriptSignalBase::None
+	 */
+	std::size_t Free = None;
+
+	/**
+	 * @brief Number of fires running, including fires made by a function
+	 *
+	 * @see ScriptSignalBase::Dispatching
+	 */
+	std::size_t Depth = 0;
+
+	/**
+	 * @brief Last coroutine suspended on the signal, an intrusive list of
+	 * ScriptSignalBase::Awaiter living in the coroutine frames, or in the
+	 * stack of threads blocked in ScriptSignalBase::WaitForArgs
+	 *
+	 * @see ScriptSignalBase::Resume
+	 * @see ScriptSignalBase::Receive
+	 */
+	std::atomic<Awaiter*> Awaiting{nullptr};
+
+	/**
+	 * @brief Waiting machinery of ScriptSignalBase::Wait
+	 *
+	 * @see ScriptSignalBase::Fire
+	 * @see ScriptSignalBase::Wait
+	 */
+	ScriptWaiter Waiter;
+
+	/**
+	 * @brief Access synchronization for ScriptSignalBase::Awaiting
+	 *
+	 * @note A spin lock, as it is only held to link or unlink a node
+	 */
+	std::atomic<bool> Locked{false};
+
+	/**
+	 * @brief If some function was marked Dead or Spent, or some link unlinked, since the last compaction
+	 *
+	 * @see ScriptSignalBase::Compact
+	 */
+	bool Dirty = false;
+
+#ifdef CPPScriptSignalMetrics
+	/**
+	 * @brief The calls measured for each function in ScriptSignalBase::Functions
+	 *
+	 * @see ScriptSignalBase::Invoke
+	 */
+	std::vector<ScriptMetrics> Measured;
+
+	/**
+	 * @brief Number of fires and time spent in them
+	 *
+	 * @see ScriptSignalBase::Metrics
+	 */
+	std::uint64_t Fires = 0;
+
+	/** @copydoc ScriptSignalBase::Fires */
+	std::chrono::nanoseconds Dispatch{0};
+
+#endif
+	/**
+	 * @brief Point the slots of the functions from a position to their new positions
+	 *
+	 * @param First Position of the first function that moved
+	 */
+	void Renumber(std::size_t First) {
+		for (std::size_t Position = First; Position < Functions.size(); ++Position) {
+			Slots[Records[Position].Index].Position = Position;
+		}
+	}
+
+	/**
+	 * @brief Erase the function of a slot, if the generation still matches
+	 *
+	 * The slot's generation is increased, so the connection is
+	 * disconnected right away. Outside of a fire the function is removed,
+	 * during a fire it is only marked Dead (or, if the connection is
+	 * deferred, not connected) and removed by ScriptSignalBase::Compact,
+	 * so the fire's loop is never invalidated
+	 *
+	 * @see ScriptSignalBase::Connection::Disconnect
+	 *
+	 * @param Index Index of the slot in ScriptSignalBase::Slots
+	 * @param Generation Generation of the slot held by the connection
+	 */
+	void Erase(std::size_t Index, std::uint32_t Generation) {
+		Slot& Target = Slots[Index];
+
+		if (Target.Generation != Generation) {
+			return;
+		}
+
+		++Target.Generation;
+
+		if (Depth == 0) {
+			Remove(Index);
+			return;
+		}
+
+		if (Target.Position != None) {
+			Records[Target.Position].State = Dead;
+			Dirty = true;
+		}
+	}
+
+	/**
+	 * @brief Disconnect the function of a slot and mark it Dead, even outside of a fire
+	 *
+	 * @see ScriptSignalBase::Sweep
+	 *
+	 * @param Index Index of the slot in ScriptSignalBase::Slots
+	 * @param Generation Generation of the slot held by the connection
+	 */
+	void Detach(std::size_t Index, std::uint32_t Generation) {
+		Slot& Target = Slots[Index];
+
+		if (Target.Generation != Generation) {
+			return;
+		}
+
+		++Target.Generation;
+
+		if (Target.Position != None) {
+			Records[Target.Position].State = Dead;
+			Dirty = true;
+		}
+	}
+
+	/**
+	 * @brief Disconnect many connections with one compaction per signal
+	 *
+	 * Every function is first marked Dead, then each signal that isn't
+	 * firing is compacted, so the whole batch is a single pass over
+	 * ScriptSignalBase::Functions per signal
+	 *
+	 * @see ScriptSignalBase::ConnectionGroup::Disconnect
+	 *
+	 * @param Members Connections to be disconnected
+	 */
+	static void Sweep(const std::vector<Connection>& Members) {
+		for (const auto& Member : Members) {
+			if (Member.Signal) {
+				Member.Signal->Detach(Member.Index, Member.Generation);
+			}
+		}
+
+		for (const auto& Member : Members) {
+			if (Member.Signal && Member.Signal->Depth == 0 && Member.Signal->Dirty) {
+				Member.Signal->Compact();
+			}
+		}
+	}
+
+	/**
+	 * @brief Remove the function of a slot and free the slot
+	 *
+	 * The functions after it are moved back by one, so every bucket
+	 * keeps the order its functions were connected in. Then the slot is
+	 * pushed to the free list
+	 *
+	 * @note Must not be called during a fire
+	 *
+	 * @param Index Index of the slot in ScriptSignalBase::Slots
+	 */
+	void Remove(std::size_t Index) {
+		Slot& Target = Slots[Index];
+		const std::size_t Position = Target.Position;
+		const std::size_t Owner = Locate(Position);
+
+		Functions.erase(Functions.begin() + Position);
+		Records.erase(Records.begin() + Position);
+#ifdef CPPScriptSignalMetrics
+		Measured.erase(Measured.begin() + Position);
+#endif
+		Renumber(Position);
+
+		for (std::size_t Current = Owner; Current < Buckets.size(); ++Current) {
+			--Buckets[Current].End;
+		}
+
+		if (Buckets[Owner].End == (Owner == 0 ? 0 : Buckets[Owner - 1].End)) {
+			Buckets.erase(Buckets.begin() + Owner);
+		}
+
+		Release(Index);
+
+		if (Functions.empty()) {
+			Self().OnLastDisconnect();
+		}
+	}
+
+	/**
+	 * @brief Push a slot whose function was removed to the free list
+	 *
+	 * @param Index Index of the slot in ScriptSignalBase::Slots
+	 */
+	void Release(std::size_t Index) {
+		Slots[Index].Position = Free;
+		Free = Index;
+
+		if (Extra && Index < Extra->Watched.size()) {
+			Extra->Watched[Index].reset();
+		}
+	}
+
+	/**
+	 * @brief Insert a function at the end of its bucket of ScriptSignalBase::Functions
+	 *
+	 * The function is pushed back and the functions of the following
+	 * buckets are moved forward by one to make room for it, so every
+	 * bucket keeps the order its functions were connected in. Connecting
+	 * to the lowest priority, as with a single bucket, moves nothing
+	 *
+	 * @note Must not be called during a fire
+	 *
+	 * @param Index Index of the function's slot in ScriptSignalBase::Slots
+	 * @param Listener Function to be inserted
+	 * @param Priority Priority of the function
+	 * @param State Live, Once or Tracked
+	 */
+	void Insert(std::size_t Index, Function&& Listener, int Priority, std::uint8_t State) {
+		auto Found = std::lower_bound(Buckets.begin(), Buckets.end(), Priority, [](const Bucket& Range, int Value) {
+			return Range.Priority > Value;
+		});
+
+		if (Found == Buckets.end() || Found->Priority != Priority) {
+			Found = Buckets.insert(Found, {Priority, Found == Buckets.begin() ? 0 : std::prev(Found)->End});
+		}
+
+		const std::size_t Position = Found->End;
+		Slots[Index].Position = Functions.size();
+		Functions.push_back(std::move(Listener));
+		Records.push_back({Index, State});
+#ifdef CPPScriptSignalMetrics
+		Measured.emplace_back();
+#endif
+
+		if (Position + 1 != Functions.size()) {
+			std::rotate(Functions.begin() + Position, std::prev(Functions.end()), Functions.end());
+			std::rotate(Records.begin() + Position, std::prev(Records.end()), Records.end());
+#ifdef CPPScriptSignalMetrics
+			std::rotate(Measured.begin() + Position, std::prev(Measured.end()), Measured.end());
+#endif
+			Renumber(Position);
+		}
+
+		for (; Found != Buckets.end(); ++Found) {
+			++Found->End;
+		}
+
+		if (Functions.size() == 1) {
+			Self().OnFirstConnect();
+		}
+	}
+
+	/**
+	 * @brief Take a slot and connect a function, or defer it during a fire
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 * @see ScriptSignalBase::ConnectOnce(Function, int)
+	 *
+	 * @param Listener Function to be connected
+	 * @param Priority Priority of the function
+	 * @param State Live, Once or Tracked
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection Attach(Function&& Listener, int Priority, std::uint8_t State) {
+		return Attach(Claim(), std::move(Listener), Priority, State);
+	}
+
+	/**
+	 * @brief Take a slot from the free list, or a new one
+	 *
+	 * @return std::size_t Index of the slot in ScriptSignalBase::Slots
+	 */
+	std::size_t Claim() {
+		std::size_t Index = Free;
+
+		if (Index == None) {
+			Index = Slots.size();
+			Slots.push_back({0, 0});
+		} else {
+			Free = Slots[Index].Position;
+		}
+
+		return Index;
+	}
+
+	/**
+	 * @brief Connect a function to a claimed slot, or defer it during a fire
+	 *
+	 * @see ScriptSignalBase::Claim
+	 *
+	 * @param Index Index of the slot in ScriptSignalBase::Slots
+	 * @param Listener Function to be connected
+	 * @param Priority Priority of the function
+	 * @param State Live, Once or Tracked
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection Attach(std::size_t Index, Function&& Listener, int Priority, std::uint8_t State) {
+		if (Depth == 0) {
+			Insert(Index, std::move(Listener), Priority, State);
+		} else {
+			Slots[Index].Position = None;
+			Extend().Incoming.push_back({std::move(Listener), Priority, Index, Slots[Index].Generation, State});
+		}
+
+		return Connection(this, Index, Slots[Index].Generation);
+	}
+
+	/**
+	 * @brief Remove the Dead functions and connect the deferred ones
+	 *
+	 * The functions left are moved back over the Dead ones in a single
+	 * pass, so every bucket keeps the order its functions were connected
+	 * in. Deferred connections disconnected before the compaction only
+	 * free their slot
+	 *
+	 * @see ScriptSignalBase::Dispatching
+	 */
+	void Compact() {
+		if (Dirty) {
+			Dirty = false;
+
+			const std::size_t Count = Functions.size();
+			std::size_t Kept = 0;
+			auto Range = Buckets.begin();
+
+			for (std::size_t Position = 0; Position < Count; ++Position) {
+				for (; Range->End == Position; ++Range) {
+					Range->End = Kept;
+				}
+
+				Record& Entry = Records[Position];
+
+				if (Entry.State == Spent) {
+					++Slots[Entry.Index].Generation;
+					Entry.State = Dead;
+				}
+
+				if (Entry.State == Dead) {
+					Release(Entry.Index);
+					continue;
+				}
+
+				if (Kept != Position) {
+					Functions[Kept] = std::move(Functions[Position]);
+					Records[Kept] = Entry;
+#ifdef CPPScriptSignalMetrics
+					Measured[Kept] = Measured[Position];
+#endif
+					Slots[Entry.Index].Position = Kept;
+				}
+
+				++Kept;
+			}
+
+			if (Kept != Count) {
+				for (; Range != Buckets.end(); ++Range) {
+					Range->End = Kept;
+				}
+
+				Functions.erase(Functions.begin() + Kept, Functions.end());
+				Records.erase(Records.begin() + Kept, Records.end());
+#ifdef CPPScriptSignalMetrics
+				Measured.erase(Measured.begin() + Kept, Measured.end());
+#endif
+				Buckets.erase(std::unique(Buckets.begin(), Buckets.end(), [](const Bucket& Previous, const Bucket& Current) {
+					return Previous.End == Current.End;
+				}), Buckets.end());
+
+				if (!Buckets.empty() && Buckets.front().End == 0) {
+					Buckets.erase(Buckets.begin());
+				}
+
+				if (Kept == 0) {
+					Self().OnLastDisconnect();
+				}
+			}
+
+			if (Extra) {
+				Extra->Links.erase(std::remove_if(Extra->Links.begin(), Extra->Links.end(), [](const Link& Entry) {
+					return Entry.Target == nullptr;
+				}), Extra->Links.end());
+			}
+		}
+
+		if (!Extra) {
+			return;
+		}
+
+		for (auto& Entry : Extra->Incoming) {
+			Slot& Target = Slots[Entry.Index];
+
+			if (Target.Generation == Entry.Generation) {
+				Insert(Entry.Index, std::move(Entry.Listener), Entry.Priority, Entry.State);
+			} else {
+				Release(Entry.Index);
+			}
+		}
+
+		Extra->Incoming.clear();
+	}
+
+	/**
+	 * @brief Marks a fire as running while it is in scope
+	 *
+	 * The outermost fire compacts the signal when it returns or throws
+	 *
+	 * @see ScriptSignalBase::Compact
+	 */
+	struct Dispatching {
+		/** Signal being fired */
+		ScriptSignalBase& Signal;
+
+		/** Enter a fire of the signal */
+		Dispatching(ScriptSignalBase& Owner) : Signal(Owner) {
+			++Signal.Depth;
+		}
+
+		/** Leave the fire, compacting after the outermost one */
+		~Dispatching() {
+			if (--Signal.Depth == 0 && (Signal.Dirty || (Signal.Extra && !Signal.Extra->Incoming.empty()))) {
+				Signal.Compact();
+			}
+		}
+	};
+
+	/**
+	 * @brief Fire all signals of ScriptSignalBase::Links
+	 *
+	 * Each link is copied before firing its target, so a link made by
+	 * the target doesn't invalidate the loop, and isn't fired until the
+	 * next fire
+	 *
+	 * @param Arguments Arguments to be passed to the targets
+	 */
+	template <typename... Values> inline void Relay(Values&... Arguments) {
+		if (!Extra) {
+			return;
+		}
+
+		for (std::size_t Position = 0, Count = Extra->Links.size(); Position < Count; ++Position) {
+			const Link Entry = Extra->Links[Position];
+
+			if (Entry.Target) {
+				Entry.Dispatch(Entry.Target, Arguments...);
+			}
+		}
+	}
+
+	/**
+	 * @brief Call a function of ScriptSignalBase::Functions by its state
+	 *
+	 * Live functions are called, Once functions are erased and then
+	 * called (so a fire made by the function doesn't call it again),
+	 * Tracked functions are called while their owner is alive and erased
+	 * once it expired, Dead and Spent functions are skipped
+	 *
+	 * @param Position Position of the function
+	 * @param Arguments Arguments to be passed to the function
+	 */
+	template <typename... Values> inline void Call(std::size_t Position, Values&... Arguments) {
+		const std::uint8_t State = Records[Position].State;
+
+		if (State == Live) {
+			Invoke(Position, Arguments...);
+		} else if (State == Once) {
+			const std::size_t Index = Records[Position].Index;
+			Erase(Index, Slots[Index].Generation);
+			Invoke(Position, Arguments...);
+		} else if (State == Tracked) {
+			const std::size_t Index = Records[Position].Index;
+
+			if (Extra->Watched[Index].expired()) {
+				Erase(Index, Slots[Index].Generation);
+			} else {
+				Invoke(Position, Arguments...);
+			}
+		}
+	}
+
+	/**
+	 * @brief Call a function of ScriptSignalBase::Functions
+	 *
+	 * @note With `CPPScriptSignalMetrics` defined, the call is timed and
+	 * recorded in ScriptSignalBase::Measured
+	 *
+	 * @see ScriptTraceScope
+	 *
+	 * @param Position Position of the function
+	 * @param Arguments Arguments to be passed to the function
+	 */
+	template <typename... Values> inline void Invoke(std::size_t Position, Values&... Arguments) {
+		ScriptTraceScope Trace(this, Named(), Records[Position].Index);
+
+#ifdef CPPScriptSignalMetrics
+		const auto Start = std::chrono::steady_clock::now();
+		Functions[Position](Arguments...);
+		Measured[Position].Record(std::chrono::steady_clock::now() - Start);
+#else
+		Functions[Position](Arguments...);
+#endif
+	}
+
+#ifdef CPPScriptSignalMetrics
+	/**
+	 * @brief Measures the fires dispatched while it is in scope
+	 *
+	 * @see ScriptSignalBase::Metrics
+	 */
+	struct Measuring {
+		/** Signal being fired */
+		ScriptSignalBase& Signal;
+
+		/** Start of the dispatch */
+		std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+		/**
+		 * @brief Count the fires of the dispatch
+		 *
+		 * @param Owner Signal being fired
+		 * @param Count Number of fires dispatched
+		 */
+		Measuring(ScriptSignalBase& Owner, std::size_t Count) : Signal(Owner) {
+			Signal.Fires += Count;
+		}
+
+		/** Add the time spent in the dispatch */
+		~Measuring() {
+			Signal.Dispatch += std::chrono::steady_clock::now() - Start;
+		}
+	};
+#endif
+
+	/**
+	 * @brief Return the bucket of a position in ScriptSignalBase::Functions
+	 *
+	 * @param Position Position of a function
+	 *
+	 * @return std::size_t Index in ScriptSignalBase::Buckets
+	 */
+	std::size_t Locate(std::size_t Position) const {
+		return std::upper_bound(Buckets.begin(), Buckets.end(), Position, [](std::size_t Value, const Bucket& Range) {
+			return Value < Range.End;
+		}) - Buckets.begin();
+	}
+
+	/**
+	 * @brief Return the signal as its most derived class
+	 *
+	 * @return Derived&
+	 */
+	inline Derived& Self() {
+		return static_cast<Derived&>(*this);
+	}
+
+	/**
+	 * @brief Called when the first function is connected to an empty signal
+	 *
+	 * @note Shadowed by Derived to be customized
+	 *
+	 * @see ScriptSignalBase::Connect
+	 */
+	void OnFirstConnect() {}
+
+	/**
+	 * @brief Called when the last function of the signal is disconnected
+	 *
+	 * @note Shadowed by Derived to be customized
+	 *
+	 * @see ScriptSignalBase::Erase
+	 */
+	void OnLastDisconnect() {}
+
+	/** Copy of the arguments of a queued fire */
+	using Event = std::tuple<std::decay_t<Parameters>...>;
+
+	/**
+	 * @brief Struct of the state only used by some signals
+	 *
+	 * @see ScriptSignalBase::Extra
+	 */
+	struct Extension {
+		/**
+		 * @brief The owner of each Tracked function, by slot index
+		 *
+		 * Indexed like ScriptSignalBase::Slots, so it never moves with the
+		 * functions, and only grown by the first tracked connection
+		 *
+		 * @see ScriptSignalBase::Connect(const std::weak_ptr<Owner>&, Method, int)
+		 */
+		std::vector<std::weak_ptr<const void>> Watched;
+
+		/**
+		 * @brief Connections made during a fire, connected by ScriptSignalBase::Compact
+		 *
+		 * @note Its capacity is kept, so it doesn't allocate once grown
+		 */
+		std::vector<Deferred> Incoming;
+
+		/**
+		 * @brief Signals fired after ScriptSignalBase::Functions, in linking order
+		 *
+		 * @see ScriptSignalBase::Forward
+		 * @see ScriptSignalBase::Relay
+		 */
+		std::vector<Link> Links;
+
+		/**
+		 * @brief Contiguous buffer of the fires waiting for ScriptSignalBase::Flush
+		 *
+		 * @note Its capacity is kept between flushes, so queueing doesn't
+		 * allocate once the buffer has grown to the usual batch size
+		 *
+		 * @see ScriptSignalBase::Queue
+		 */
+		std::vector<Event> Queued;
+
+		/**
+		 * @brief Position in Queued of each coalesced key
+		 *
+		 * @see ScriptSignalBase::Coalesce
+		 */
+		std::unordered_map<std::size_t, std::size_t> Keys;
+
+		/**
+		 * @brief Name of the signal shown by tracing, or `nullptr`
+		 *
+		 * @see ScriptSignalBase::ScriptSignalBase(const char*)
+		 */
+		const char* Name = nullptr;
+	};
+
+	/**
+	 * @brief Tracked owners, deferred connections, links, queued fires and
+	 * name, allocated when a signal first needs one of them
+	 *
+	 * A signal that only connects and fires pays for the pointer alone,
+	 * which keeps the signals small in arrays of per-entity signals
+	 *
+	 * @see ScriptSignalBase::Extend
+	 */
+	std::unique_ptr<Extension> Extra;
+
+	/**
+	 * @brief Return the state only used by some signals, allocating it on the first call
+	 *
+	 * @return ScriptSignalBase::Extension&
+	 */
+	Extension& Extend() {
+		if (!Extra) {
+			Extra = std::make_unique<Extension>();
+		}
+
+		return *Extra;
+	}
+
+	/**
+	 * @brief Return if some signal is linked by ScriptSignalBase::Forward
+	 *
+	 * @return bool
+	 */
+	inline bool Linked() const {
+		return Extra && !Extra->Links.empty();
+	}
+
+	/**
+	 * @brief Return the name of the signal shown by tracing, or `nullptr`
+	 *
+	 * @return const char*
+	 */
+	inline const char* Named() const {
+		return Extra ? Extra->Name : nullptr;
+	}
+
+	struct Pending {
+		/** Signal to be fired */
+		Derived* Signal;
+
+		/** Copy of the arguments */
+		Event Arguments;
+
+		/** If every function was called */
+		std::atomic<bool> Finished{false};
+
+		/**
+		 * @brief Reference held by the posted task until it runs
+		 *
+		 * The task only captures a pointer to the state, small enough to be
+		 * stored inline by `std::function`, so posting it doesn't allocate
+		 *
+		 * @see ScriptSignalBase::FireAsync
+		 */
+		std::shared_ptr<Pending> Keeping;
+
+		/**
+		 * @brief Construct the state of a fire
+		 *
+		 * @param Owner Signal to be fired
+		 * @param Values Arguments to be copied
+		 */
+		Pending(Derived* Owner, ScriptArgument<Parameters>... Values) : Signal(Owner), Arguments(Values...) {}
+
+		/**
+		 * @brief Fire the signal, then mark the ticket as done
+		 *
+		 * @see ScriptSignalBase::Ticket::Wait
+		 */
+		void Run() {
+			const std::shared_ptr<Pending> Held = std::move(Keeping);
+			std::apply([this](auto&... Values) { Signal->Fire(Values...); }, Arguments);
+
+			Finished.store(true);
+			Finished.notify_all();
+		}
+	};
+
+public:
+	/**
+	 * @brief Struct of the awaitable returned by `co_await` on a signal
+	 *
+	 * It lives in the frame of the suspended coroutine and is linked in
+	 * ScriptSignalBase::Awaiting, so awaiting a signal allocates nothing
+	 */
+	struct Awaiter {
+	protected:
+		friend ScriptSignalBase;
+
+		/** Signal awaited */
+		ScriptSignalBase* Signal;
+
+		/** Executor resuming the coroutine, or `nullptr` to resume it inside the fire */
+		void* Target;
+
+		/** Post the resume of a coroutine to Target */
+		void (*Schedule)(void*, std::coroutine_handle<>);
+
+		/** Coroutine suspended after this one */
+		Awaiter* Previous = nullptr;
+
+		/** Coroutine suspended before this one */
+		Awaiter* Next = nullptr;
+
+		/** Suspended coroutine */
+		std::coroutine_handle<> Handle;
+
+		/** Copy of the arguments of the fire, made before resuming */
+		std::optional<Event> Arguments;
+
+		/** If the node is in ScriptSignalBase::Awaiting */
+		bool Linked = false;
+
+	public:
+		/**
+		 * @brief Construct the awaitable of a signal's next fire
+		 *
+		 * @param Owner Signal to be awaited
+		 * @param Executor Executor resuming the coroutine, or `nullptr`
+		 * @param Post Post the resume of a coroutine to Executor
+		 */
+		Awaiter(ScriptSignalBase* Owner, void* Executor = nullptr, void (*Post)(void*, std::coroutine_handle<>) = nullptr)
+			: Signal(Owner), Target(Executor), Schedule(Post) {}
+
+		Awaiter(const Awaiter&) = delete;
+		Awaiter& operator=(const Awaiter&) = delete;
+
+		/**
+		 * @brief Unlink the node if the coroutine is destroyed while suspended
+		 *
+		 * @note A suspended coroutine must not be destroyed while the signal is firing
+		 */
+		~Awaiter() {
+			if (Linked) {
+				Signal->Withdraw(*this);
+			}
+		}
+
+		/** Always suspend, until the next fire */
+		inline bool await_ready() const noexcept {
+			return false;
+		}
+
+		/**
+		 * @brief Link the suspended coroutine to the signal
+		 *
+		 * @param Suspended Coroutine awaiting the signal
+		 */
+		void await_suspend(std::coroutine_handle<> Suspended) {
+			Handle = Suspended;
+			Signal->Enlist(*this);
+		}
+
+		/**
+		 * @brief Return the arguments of the fire that resumed the coroutine
+		 *
+		 * @return ScriptSignalBase::Event
+		 */
+		Event await_resume() {
+			return std::move(*Arguments);
+		}
+	};
+
+protected:
+	/** Take ScriptSignalBase::Locked */
+	void Lock() {
+		while (Locked.exchange(true, std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+	}
+
+	/** Release ScriptSignalBase::Locked */
+	void Unlock() {
+		Locked.store(false, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Link a suspended coroutine to ScriptSignalBase::Awaiting
+	 *
+	 * @param Node Awaitable in the coroutine's frame
+	 */
+	void Enlist(Awaiter& Node) {
+		Lock();
+		Awaiter* Head = Awaiting.load(std::memory_order_relaxed);
+		Node.Next = Head;
+		Node.Previous = nullptr;
+		Node.Linked = true;
+
+		if (Head) {
+			Head->Previous = &Node;
+		}
+
+		Awaiting.store(&Node, std::memory_order_relaxed);
+		Unlock();
+	}
+
+	/**
+	 * @brief Unlink a coroutine that is still suspended from ScriptSignalBase::Awaiting
+	 *
+	 * @param Node Awaitable in the coroutine's frame
+	 */
+	bool Withdraw(Awaiter& Node) {
+		Lock();
+		const bool Removed = Node.Linked;
+
+		if (Node.Linked) {
+			if (Node.Previous) {
+				Node.Previous->Next = Node.Next;
+			} else {
+				Awaiting.store(Node.Next, std::memory_order_relaxed);
+			}
+
+			if (Node.Next) {
+				Node.Next->Previous = Node.Previous;
+			}
+
+			Node.Linked = false;
+		}
+
+		Unlock();
+		return Removed;
+	}
+
+	/**
+	 * @brief Block the thread until a fire hands it the arguments, or until Deadline
+	 *
+	 * A node on the stack is linked to ScriptSignalBase::Awaiting as a
+	 * suspended coroutine would be, and the fire copies its arguments in
+	 * the node and sets a flag instead of resuming a coroutine
+	 *
+	 * @see ScriptWaiter::WaitReady
+	 *
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
+	 *
+	 * @return std::optional<ScriptSignalBase::Event> Arguments of the fire, or empty if it timed out
+	 */
+	std::optional<Event> Receive(const std::chrono::steady_clock::time_point* Deadline) {
+		std::atomic<bool> Delivered{false};
+		Awaiter Node(this, &Delivered, [](void* Flag, std::coroutine_handle<>) {
+			static_cast<std::atomic<bool>*>(Flag)->store(true, std::memory_order_release);
+		});
+
+		Enlist(Node);
+
+		const auto Ready = [&Delivered] { return Delivered.load(std::memory_order_acquire); };
+
+		if (!Waiter.WaitReady(Ready, Deadline) && Withdraw(Node)) {
+			return std::nullopt;
+		}
+
+		// A fire took the node before it could be withdrawn, it sets the flag shortly
+		while (!Delivered.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+
+		return std::move(Node.Arguments);
+	}
+
+	/**
+	 * @brief Resume every coroutine suspended on the signal, in suspending order
+	 *
+	 * The whole list is taken at once, so a coroutine that awaits the
+	 * signal again when resumed waits for the next fire. The arguments
+	 * are copied in every node before any coroutine is resumed
+	 *
+	 * @param Arguments Arguments of the fire
+	 */
+	template <typename... Values> void Resume(Values&... Arguments) {
+		if (!Awaiting.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		Lock();
+		Awaiter* Last = Awaiting.exchange(nullptr, std::memory_order_relaxed);
+		for (Awaiter* Current = Last; Current; Current = Current->Next) {
+			Current->Linked = false;
+			Last = Current;
+		}
+		Unlock();
+
+		for (Awaiter* Current = Last; Current; Current = Current->Previous) {
+			Current->Arguments.emplace(Arguments...);
+		}
+
+		while (Last) {
+			Awaiter* Current = std::exchange(Last, Last->Previous);
+
+			if (Current->Schedule) {
+				Current->Schedule(Current->Target, Current->Handle);
+			} else {
+				Current->Handle.resume();
+			}
+		}
+	}
+
+	/**
+	 * @brief Deconstruct Signal
+	 *
+	 * Connections are handles to slots owned by the signal, so there
+	 * is nothing to deallocate for them, only the vectors are released
+	 *
+	 * @note Not virtual, a signal must not be deleted through a pointer
+	 * to this class, and connections of a deconstructed signal must not be used
+	 */
+	~ScriptSignalBase() = default;
+
+public:
+	/** Construct a signal without a name */
+	ScriptSignalBase() = default;
+
+	/**
+	 * @brief Construct a signal with a name shown by tracing
+	 *
+	 * @note The name isn't copied, it must outlive the signal (like a string literal).
+	 * It is kept in ScriptSignalBase::Extra, allocated by this constructor
+	 *
+	 * @see ScriptTracing
+	 *
+	 * @param Label Name of the signal
+	 */
+	explicit ScriptSignalBase(const char* Label) {
+		Extend().Name = Label;
+	}
+
+	/**
+	 * @brief Create a new connection and it's function, with priority 0
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection Connect(Function Listener) {
+		return Connect(std::move(Listener), 0);
+	}
+
+	/**
+	 * @brief Create a new connection and it's function with a priority
+	 *
+	 * Takes a slot from the free list (or a new one) and push back the
+	 * connection's function in ScriptSignalBase::Functions vector.
+	 * The connection is constructed with the slot's index and
+	 * generation, that stay valid while the function moves
+	 * inside ScriptSignalBase::Functions
+	 *
+	 * Functions are kept sorted in buckets of the same priority, the
+	 * new function is inserted at the end of its bucket, so only the
+	 * functions of lower priorities move
+	 *
+	 * Disconnected slots are reused, so under connect and disconnect
+	 * churn the memory stays bounded by the most connections at once,
+	 * and no allocation happens once the vectors have grown
+	 *
+	 * A connection made during a fire is deferred, its function is first
+	 * called by the next fire after the outermost one returns
+	 *
+	 * @see ScriptSignalBase::Connection:Connection
+	 *
+	 * @note The function is moved into ScriptSignalBase::Functions, so
+	 * move-only function types (like InlineDelegate) can be used
+	 *
+	 * @note Functions with a higher priority are called first, functions
+	 * with the same priority are called in the order they were connected
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection Connect(Function Listener, int Priority) {
+		return Attach(std::move(Listener), Priority, Live);
+	}
+
+	/**
+	 * @brief Create a connection whose function is only called by the next fire, with priority 0
+	 *
+	 * @see ScriptSignalBase::ConnectOnce(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection ConnectOnce(Function Listener) {
+		return ConnectOnce(std::move(Listener), 0);
+	}
+
+	/**
+	 * @brief Create a connection whose function is only called by the next fire
+	 *
+	 * The connection is disconnected right before its function is called,
+	 * so `Connected()` is `false` inside the function and a fire made by
+	 * it doesn't call the function again
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	Connection ConnectOnce(Function Listener, int Priority) {
+		return Attach(std::move(Listener), Priority, Once);
+	}
+
+	/**
+	 * @brief Create a connection calling a method of an object owned by a `std::shared_ptr`, with priority 0
+	 *
+	 * @see ScriptSignalBase::Connect(const std::weak_ptr<Owner>&, Method, int)
+	 *
+	 * @param Target Owner of the object
+	 * @param Member Method to be called, or any callable taking the object first
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	template <typename Owner, typename Method> Connection Connect(const std::weak_ptr<Owner>& Target, Method Member) {
+		return Connect(Target, std::move(Member), 0);
+	}
+
+	/**
+	 * @brief Create a connection calling a method of an object owned by a `std::shared_ptr`
+	 *
+	 * The signal keeps a `std::weak_ptr` of the owner next to the
+	 * function, and checks if it expired before each call: a single
+	 * load of the control block, the object isn't locked. Once the owner
+	 * is destroyed, the next fire skips the function and disconnects
+	 * it, and it is removed by the compaction after the fire
+	 *
+	 * @code
+	 * Hit.Connect(std::weak_ptr(Enemy), &Enemy::OnHit);
+	 * @endcode
+	 *
+	 * @note The owner must not be destroyed by another thread while
+	 * the signal is firing, as for any connected function
+	 *
+	 * @note An owner that already expired isn't connected, a
+	 * disconnected connection is returned
+	 *
+	 * @param Target Owner of the object
+	 * @param Member Method to be called, or any callable taking the object first
+	 * @param Priority Priority of the function
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	template <typename Owner, typename Method> Connection Connect(const std::weak_ptr<Owner>& Target, Method Member, int Priority) {
+		Owner* Object = Target.lock().get();
+
+		if (!Object) {
+			return Connection();
+		}
+
+		const std::size_t Index = Claim();
+		Extension& Extended = Extend();
+
+		if (Extended.Watched.size() <= Index) {
+			Extended.Watched.resize(Slots.size());
+		}
+
+		Extended.Watched[Index] = Target;
+		return Attach(Index, Function([Object, Member](ScriptArgument<Parameters>... Arguments) {
+			std::invoke(Member, Object, Arguments...);
+		}), Priority, Tracked);
+	}
+
+	/**
+	 * @brief Connect many functions at once, with priority 0
+	 *
+	 * @see ScriptSignalBase::ConnectMany(Range&&, int)
+	 *
+	 * @param Listeners Range of functions or lambdas to be used in connections
+	 *
+	 * @return ScriptSignalBase::ConnectionGroup
+	 */
+	template <typename Range> ConnectionGroup ConnectMany(Range&& Listeners) {
+		return ConnectMany(std::forward<Range>(Listeners), 0);
+	}
+
+	/**
+	 * @brief Connect many functions at once with a priority
+	 *
+	 * Room is reserved for the whole range first when its size is known,
+	 * so the vectors grow once. The functions of a range passed as an
+	 * rvalue are moved
+	 *
+	 * @code
+	 * auto Level = Hit.ConnectMany(Handlers);
+	 * Level.Disconnect();
+	 * @endcode
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 * @see ScriptSignalBase::ConnectionGroup
+	 *
+	 * @param Listeners Range of functions or lambdas to be used in connections
+	 * @param Priority Priority of the functions
+	 *
+	 * @return ScriptSignalBase::ConnectionGroup Group holding the connections
+	 */
+	template <typename Range> ConnectionGroup ConnectMany(Range&& Listeners, int Priority) {
+		ConnectionGroup Group;
+
+		if constexpr (requires { std::size(Listeners); }) {
+			const std::size_t Count = std::size(Listeners);
+			Reserve(Functions.size() + Count);
+			Group.Reserve(Count);
+		}
+
+		for (auto&& Listener : Listeners) {
+			if constexpr (std::is_lvalue_reference_v<Range>) {
+				Group.Add(Attach(Function(Listener), Priority, Live));
+			} else {
+				Group.Add(Attach(Function(std::move(Listener)), Priority, Live));
+			}
+		}
+
+		return Group;
+	}
+
+	/**
+	 * @brief Reserve room for a number of functions, so connecting them doesn't reallocate
+	 *
+	 * @param Count Number of functions the signal will hold
+	 */
+	void Reserve(std::size_t Count) {
+		Functions.reserve(Count);
+		Records.reserve(Count);
+		Slots.reserve(Count);
+#ifdef CPPScriptSignalMetrics
+		Measured.reserve(Count);
+#endif
+	}
+
+	/**
+	 * @brief Call all functions in ScriptSignalBase::Functions vector
+	 *
+	 * If `Functions.empty()` is `false`, the function calls all
+	 * ScriptSignalBase::Functions with the given arguments in base of
+	 * the parameters created in Signal construct, from the highest priority
+	 *
+	 * @note Notifies all ScriptSignalBase::Wait waiting for
+	 * ScriptSignalBase::Fire to be called, without locking
+	 * anything when no thread is waiting
+	 *
+	 * @note The arguments are taken and passed to every function by
+	 * reference, a copy is only made by functions taking them by value
+	 *
+	 * @note Functions can connect and disconnect (themselves or any
+	 * other) during the fire, see ScriptSignalBase::Erase
+	 *
+	 * @note Linked signals are fired after all functions, see ScriptSignalBase::Forward
+	 *
+	 * @see ScriptWaiter::Notify
+	 * @see ScriptArgument
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Fire(ScriptArgument<Parameters>... Arguments) {
+		if (Functions.empty() && !Linked() && !Awaiting.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		{
+#ifdef CPPScriptSignalMetrics
+			Measuring Measure(*this, 1);
+#endif
+			ScriptTraceScope Trace(this, Named(), ScriptTracer::Dispatch);
+			Dispatching Guard(*this);
+
+			for (std::size_t Position = 0, Count = Functions.size(); Position < Count; ++Position) {
+				Call(Position, Arguments...);
+			}
+
+			Relay(Arguments...);
+			Resume(Arguments...);
+		}
+
+		Waiter.Notify();
+	}
+
+	/**
+	 * @brief Call all functions split in chunks across the workers of a pool
+	 *
+	 * ScriptSignalBase::Functions is split in chunks of Chunk functions,
+	 * that are called in parallel by the pool's workers and the calling
+	 * thread. Returns after every function was called
+	 *
+	 * @note ScriptSignalBase::Wait is only notified after the whole batch,
+	 * and linked signals are fired by the calling thread after it
+	 *
+	 * @note The functions must be safe to be called at the same time,
+	 * and the signal must not be changed while firing. Once functions
+	 * are still called by a single thread, and erased after the batch
+	 *
+	 * @see ScriptPool::Parallel
+	 *
+	 * @tparam Executor Type with a `Parallel(Count, Chunk, Work)` method, like ScriptPool
+	 *
+	 * @param Pool Pool of workers to call the functions
+	 * @param Chunk Number of functions called by a worker at once, higher for cheap functions
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	template <typename Executor> void FireParallel(Executor& Pool, std::size_t Chunk, ScriptArgument<Parameters>... Arguments) {
+		if (Functions.empty() && !Linked() && !Awaiting.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		{
+#ifdef CPPScriptSignalMetrics
+			Measuring Measure(*this, 1);
+#endif
+			ScriptTraceScope Trace(this, Named(), ScriptTracer::Dispatch);
+			Dispatching Guard(*this);
+			std::atomic<bool> Fired{false};
+
+			Pool.Parallel(Functions.size(), Chunk, [&](std::size_t Begin, std::size_t End) {
+				for (std::size_t Position = Begin; Position < End; ++Position) {
+					std::atomic_ref<std::uint8_t> State(Records[Position].State);
+					const std::uint8_t Current = State.load(std::memory_order_relaxed);
+
+					if (Current == Live) {
+						Invoke(Position, Arguments...);
+					} else if (Current == Once && State.exchange(Spent) == Once) {
+						Fired.store(true, std::memory_order_relaxed);
+						Invoke(Position, Arguments...);
+					} else if (Current == Tracked) {
+						if (!Extra->Watched[Records[Position].Index].expired()) {
+							Invoke(Position, Arguments...);
+						} else if (State.exchange(Spent) == Tracked) {
+							Fired.store(true, std::memory_order_relaxed);
+						}
+					}
+				}
+			});
+
+			Dirty = Dirty || Fired.load();
+			Relay(Arguments...);
+			Resume(Arguments...);
+		}
+
+		Waiter.Notify();
+	}
+
+	/**
+	 * @brief Post a fire to an executor and return without calling any function
+	 *
+	 * The arguments are copied, together with the completion flag, in a
+	 * single allocation shared by the posted task and the returned ticket.
+	 * The task is a lambda of one pointer, that `std::function` stores
+	 * inline, so ScriptPool::Post adds no allocation besides the growth
+	 * of its queue
+	 *
+	 * @note The signal must outlive the task, and must not be changed
+	 * while the task may be firing it. The executor must run every posted
+	 * task, a dropped task leaks its state
+	 *
+	 * @see ScriptSignalBase::Ticket
+	 *
+	 * @tparam Executor Type with a `Post(Task)` method, like ScriptPool
+	 *
+	 * @param Target Executor to run the fire
+	 * @param Arguments Arguments in base of Signal's parameters
+	 *
+	 * @return ScriptSignalBase::Ticket Handle to wait for this fire
+	 */
+	template <typename Executor> Ticket FireAsync(Executor& Target, ScriptArgument<Parameters>... Arguments) {
+		auto State = std::make_shared<Pending>(&Self(), Arguments...);
+		Pending* Posted = State.get();
+
+		State->Keeping = State;
+		Target.Post([Posted] { Posted->Run(); });
+		return Ticket(std::move(State));
+	}
+
+	/**
+	 * @brief Queue a fire to be dispatched by ScriptSignalBase::Flush
+	 *
+	 * The arguments are copied at the end of ScriptSignalBase::Extra,
+	 * no function is called until the queue is flushed
+	 *
+	 * @note Reference parameters are queued as copies of the referenced value
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Queue(ScriptArgument<Parameters>... Arguments) {
+		Extend().Queued.emplace_back(Arguments...);
+	}
+
+	/**
+	 * @brief Queue a fire, replacing a queued fire with the same key
+	 *
+	 * Only the last arguments queued with a key before a flush are
+	 * dispatched, in the position of the first fire with that key
+	 *
+	 * @see ScriptSignalBase::Queue
+	 *
+	 * @param Key Key of the fire, like the identifier of what changed
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Coalesce(std::size_t Key, ScriptArgument<Parameters>... Arguments) {
+		Extension& Batch = Extend();
+		const auto [Found, Inserted] = Batch.Keys.try_emplace(Key, Batch.Queued.size());
+
+		if (Inserted) {
+			Batch.Queued.emplace_back(Arguments...);
+		} else {
+			Batch.Queued[Found->second] = Event(Arguments...);
+		}
+	}
+
+	/**
+	 * @brief Dispatch all queued fires
+	 *
+	 * The fires are dispatched listener by listener, each function is
+	 * called with every queued fire before the next function, so the
+	 * function's code and captures stay in cache for the whole batch
+	 *
+	 * @note Fires queued by the functions are kept for the next flush
+	 *
+	 * @see ScriptSignalBase::Extra
+	 */
+	void Flush() {
+		if (!Extra || Extra->Queued.empty()) {
+			return;
+		}
+
+		std::vector<Event> Batch;
+		Batch.swap(Extra->Queued);
+		Extra->Keys.clear();
+
+		const bool Listened = !Functions.empty() || Linked() || Awaiting.load(std::memory_order_relaxed);
+
+		{
+#ifdef CPPScriptSignalMetrics
+			Measuring Measure(*this, Listened ? Batch.size() : 0);
+#endif
+			ScriptTraceScope Trace(this, Named(), ScriptTracer::Dispatch);
+			Dispatching Guard(*this);
+
+			for (std::size_t Position = 0, Count = Functions.size(); Position < Count; ++Position) {
+				for (auto& Arguments : Batch) {
+					if (Records[Position].State >= Dead) {
+						break;
+					}
+
+					std::apply([this, Position](auto&... Values) { Call(Position, Values...); }, Arguments);
+				}
+			}
+
+			for (auto& Arguments : Batch) {
+				std::apply([this](auto&... Values) { Relay(Values...); }, Arguments);
+			}
+
+			for (auto& Arguments : Batch) {
+				std::apply([this](auto&... Values) { Resume(Values...); }, Arguments);
+			}
+		}
+
+		Batch.clear();
+		if (Extra->Queued.empty()) {
+			Extra->Queued.swap(Batch);
+		}
+
+		if (Listened) {
+			Waiter.Notify();
+		}
+	}
+
+	/**
+	 * @brief Link another signal to be fired by every fire of this one
+	 *
+	 * The target is fired through a plain function pointer, with the
+	 * arguments of this fire passed by reference, so forwarding costs no
+	 * `std::function`, no allocation and no copy. A chain of forwards
+	 * reaches its leaf functions in a single pass of nested fires
+	 *
+	 * @note The target must outlive the link, and a signal must not be
+	 * forwarded (directly or through others) to itself
+	 *
+	 * @see ScriptSignalBase::Unforward
+	 *
+	 * @tparam Signal Type of the target, any signal with a `Fire` taking these parameters
+	 *
+	 * @param Target Signal to be fired
+	 */
+	template <typename Signal> void Forward(Signal& Target) {
+		Extend().Links.push_back({&Target, [](void* Linked, ScriptArgument<Parameters>... Arguments) {
+			static_cast<Signal*>(Linked)->Fire(Arguments...);
+		}});
+	}
+
+	/**
+	 * @brief Unlink every link made by ScriptSignalBase::Forward to a signal
+	 *
+	 * @note During a fire the links are only cleared, and erased after the outermost fire returns
+	 *
+	 * @param Target Signal not to be fired anymore
+	 */
+	template <typename Signal> void Unforward(Signal& Target) {
+		if (!Extra) {
+			return;
+		}
+
+		for (auto& Entry : Extra->Links) {
+			if (Entry.Target == static_cast<void*>(&Target)) {
+				Entry.Target = nullptr;
+				Dirty = true;
+			}
+		}
+
+		if (Depth == 0) {
+			Compact();
+		}
+	}
+
+	/**
+	 * @brief Fire this signal on every fire of the given signals
+	 *
+	 * @see ScriptSignalBase::Forward
+	 *
+	 * @param Source Signals to be forwarded to this one
+	 */
+	template <typename... Signals> void Merge(Signals&... Source) {
+		(Source.Forward(Self()), ...);
+	}
+
+	/**
+	 * @brief Connect a function firing another signal with transformed arguments
+	 *
+	 * The transform is called with the arguments of each fire, and its
+	 * result fires the target: a tuple-like result (as `std::tuple` or
+	 * `std::pair`) is unpacked into the target's arguments, any other
+	 * result is its only argument
+	 *
+	 * @note The target must outlive the connection
+	 *
+	 * @param Target Signal to be fired
+	 * @param Transform Function or lambda converting the arguments
+	 *
+	 * @return ScriptSignalBase::Connection
+	 */
+	template <typename Signal, typename Converter> Connection Map(Signal& Target, Converter Transform) {
+		return Connect([&Target, Transform = std::move(Transform)](ScriptArgument<Parameters>... Arguments) {
+			using Result = decltype(Transform(Arguments...));
+
+			if constexpr (requires { std::tuple_size<Result>::value; }) {
+				std::apply([&Target](auto&&... Values) { Target.Fire(Values...); }, Transform(Arguments...));
+			} else {
+				Target.Fire(Transform(Arguments...));
+			}
+		});
+	}
+
+	/**
+	 * @brief Suspend the coroutine until the next fire, as `co_await Signal`
+	 *
+	 * The coroutine is resumed inside the next fire, after all functions
+	 * and linked signals were called, and `co_await` returns a tuple
+	 * with copies of the fire's arguments. Nothing is allocated: the
+	 * awaitable is linked to the signal from the coroutine's frame
+	 *
+	 * @code
+	 * auto [Name, Damage] = co_await Hit;
+	 * @endcode
+	 *
+	 * @note Suspending and firing can happen in different threads
+	 *
+	 * @see ScriptSignalBase::On
+	 *
+	 * @return ScriptSignalBase::Awaiter
+	 */
+	Awaiter operator co_await() {
+		return Awaiter(this);
+	}
+
+	/**
+	 * @brief Suspend the coroutine until the next fire, resumed by an executor
+	 *
+	 * As `co_await Signal`, but the fire posts the resume to the executor
+	 * instead of resuming the coroutine itself, as `co_await Signal.On(Pool)`
+	 *
+	 * @tparam Executor Type with a `Post(Task)` method, like ScriptPool
+	 *
+	 * @param Target Executor to resume the coroutine
+	 *
+	 * @return ScriptSignalBase::Awaiter
+	 */
+	template <typename Executor> Awaiter On(Executor& Target) {
+		return Awaiter(this, &Target, [](void* Owner, std::coroutine_handle<> Handle) {
+			static_cast<Executor*>(Owner)->Post([Handle] { Handle.resume(); });
+		});
+	}
+
+	/**
+	 * @brief Wait for ScriptSignalBase::Fire to be called and return elapsed time
+	 *
+	 * Captures the current fire generation and blocks until a fire
+	 * advances it, so any number of threads can wait at the same time
+	 * and each one returns on the first fire after its call
+	 *
+	 * @see ScriptWaiter::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for ScriptSignalBase::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		return Waiter.Wait();
+	}
+
+	/**
+	 * @brief Wait for ScriptSignalBase::Fire to be called for a duration
+	 *
+	 * @see ScriptWaiter::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return Waiter.WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for ScriptSignalBase::Fire to be called until a time point
+	 *
+	 * @see ScriptWaiter::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		return Waiter.WaitUntil(Time);
+	}
+
+	/**
+	 * @brief Wait for ScriptSignalBase::Fire to be called and return its arguments
+	 *
+	 * The fire copies its arguments straight in the waiting thread's
+	 * stack, so nothing is connected or allocated for the wait
+	 *
+	 * @code
+	 * auto [Name, Damage] = Hit.WaitForArgs();
+	 * @endcode
+	 *
+	 * @note The thread is woken after all functions and linked signals were called
+	 *
+	 * @see ScriptSignalBase::TryWaitForArgs
+	 *
+	 * @return ScriptSignalBase::Event Copies of the fire's arguments
+	 */
+	Event WaitForArgs() {
+		return *Receive(nullptr);
+	}
+
+	/**
+	 * @brief Wait for ScriptSignalBase::Fire to be called for a duration and return its arguments
+	 *
+	 * @see ScriptSignalBase::WaitForArgs
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<ScriptSignalBase::Event> Copies of the fire's arguments, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<Event> TryWaitForArgs(const std::chrono::duration<Representation, Period>& Timeout) {
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(Timeout);
+		return Receive(&Deadline);
+	}
+
+#ifdef CPPScriptSignalMetrics
+	/**
+	 * @brief Return a snapshot of the signal's metrics
+	 *
+	 * @note Only available when `CPPScriptSignalMetrics` is defined
+	 *
+	 * @see ScriptSignalBase::ResetMetrics
+	 *
+	 * @return ScriptSignalBase::Report
+	 */
+	Report Metrics() {
+		Report Snapshot;
+		Snapshot.Fires = Fires;
+		Snapshot.Dispatch = Dispatch;
+		Snapshot.Listeners.reserve(Functions.size());
+
+		for (std::size_t Position = 0; Position < Functions.size(); ++Position) {
+			if (Records[Position].State < Dead) {
+				const std::size_t Index = Records[Position].Index;
+				Snapshot.Listeners.push_back({Connection(this, Index, Slots[Index].Generation), Measured[Position]});
+			}
+		}
+
+		return Snapshot;
+	}
+
+	/**
+	 * @brief Clear all metrics of the signal, as after a snapshot pushed each frame
+	 *
+	 * @note Only available when `CPPScriptSignalMetrics` is defined
+	 *
+	 * @see ScriptSignalBase::Metrics
+	 */
+	void ResetMetrics() {
+		Fires = 0;
+		Dispatch = std::chrono::nanoseconds(0);
+		std::fill(Measured.begin(), Measured.end(), ScriptMetrics());
+	}
+
+#endif
+	/**
+	 * @brief Set how many times ScriptSignalBase::Wait checks for a fire before parking
+	 *
+	 * @see ScriptWaiter::Spin
+	 *
+	 * @param Count Times to spin, `0` parks right away
+	 */
+	void Spin(std::uint32_t Count) {
+		Waiter.Spin(Count);
+	}
+};
+
+/**
+ * @brief Class of signal with a custom function type and virtual methods
+ *
+ * Connect, Fire and the hooks are virtual, so the signal can be
+ * customized by overriding them in a derived class
+ *
+ * @see ScriptSignalBase
+ *
+ * @tparam Function The type used to hold the function of each connection
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename Function, typename... Parameters> class BasicScriptSignal : public ScriptSignalBase<BasicScriptSignal<Function, Parameters...>, Function, Parameters...> {
+protected:
+	/** Base class holding the implementation */
+	using Base = ScriptSignalBase<BasicScriptSignal, Function, Parameters...>;
+
+public:
+	/** Connection returned by BasicScriptSignal::Connect */
+	using typename Base::Connection;
+
+	/** Construct the signal, with a name or without */
+	using Base::Base;
+
+	/** Connect methods of objects owned by a `std::shared_ptr` */
+	using Base::Connect;
+
+	/** Deconstruct Signal */
+	virtual ~BasicScriptSignal() = default;
+
+	/**
+	 * @brief Called when the first function is connected to an empty signal
+	 *
+	 * @see ScriptSignalBase::OnFirstConnect
+	 */
+	virtual void OnFirstConnect() {}
+
+	/**
+	 * @brief Called when the last function of the signal is disconnected
+	 *
+	 * @see ScriptSignalBase::OnLastDisconnect
+	 */
+	virtual void OnLastDisconnect() {}
+
+	/**
+	 * @brief Create a new connection and it's function
+	 *
+	 * @see ScriptSignalBase::Connect
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return BasicScriptSignal::Connection
+	 */
+	virtual Connection Connect(Function Listener) {
+		return Base::Connect(std::move(Listener));
+	}
+
+	/**
+	 * @brief Create a new connection and it's function with a priority
+	 *
+	 * @see ScriptSignalBase::Connect(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function, higher is called first
+	 *
+	 * @return BasicScriptSignal::Connection
+	 */
+	virtual Connection Connect(Function Listener, int Priority) {
+		return Base::Connect(std::move(Listener), Priority);
+	}
+
+	/**
+	 * @brief Create a connection whose function is only called by the next fire
+	 *
+	 * @see ScriptSignalBase::ConnectOnce
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return BasicScriptSignal::Connection
+	 */
+	virtual Connection ConnectOnce(Function Listener) {
+		return Base::ConnectOnce(std::move(Listener));
+	}
+
+	/**
+	 * @brief Create a connection whose function is only called by the next fire, with a priority
+	 *
+	 * @see ScriptSignalBase::ConnectOnce(Function, int)
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 * @param Priority Priority of the function, higher is called first
+	 *
+	 * @return BasicScriptSignal::Connection
+	 */
+	virtual Connection ConnectOnce(Function Listener, int Priority) {
+		return Base::ConnectOnce(std::move(Listener), Priority);
+	}
+
+	/**
+	 * @brief Call all functions of the signal
+	 *
+	 * @see ScriptSignalBase::Fire
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	virtual void Fire(ScriptArgument<Parameters>... Arguments) {
+		Base::Fire(Arguments...);
+	}
+};
+
+/**
+ * @brief Class of signal without virtual methods
+ *
+ * A ScriptSignalBase holding `std::function`, that can't be derived, so
+ * Fire and Connect are inlined at every call and the signal has no vtable
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class FinalSignal final : public ScriptSignalBase<FinalSignal<Parameters...>, f_(ScriptArgument<Parameters>...), Parameters...> {
+public:
+	/** Construct the signal, with a name or without */
+	using ScriptSignalBase<FinalSignal<Parameters...>, f_(ScriptArgument<Parameters>...), Parameters...>::ScriptSignalBase;
+};
+
+/**
+ * @brief Base class of a signal customized by static hooks
+ *
+ * @code
+ * struct Tracked : CustomSignal<Tracked, int> {
+ * 	void OnFirstConnect() { Start(); }
+ * 	void OnLastDisconnect() { Stop(); }
+ * };
+ * @endcode
+ *
+ * @tparam Derived The class deriving from this one
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename Derived, typename... Parameters> using CustomSignal = ScriptSignalBase<Derived, f_(ScriptArgument<Parameters>...), Parameters...>;
+
+/**
+ * @brief Class of signal
+ *
+ * A BasicScriptSignal that holds each connection's function in a `std::function`
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class ScriptSignal : public BasicScriptSignal<f_(ScriptArgument<Parameters>...), Parameters...> {
+public:
+	/** Construct the signal, with a name or without */
+	using BasicScriptSignal<f_(ScriptArgument<Parameters>...), Parameters...>::BasicScriptSignal;
 };
 
 #undef f_
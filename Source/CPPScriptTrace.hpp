@@ -0,0 +1,232 @@
+#ifndef CPPScriptTrace
+#define CPPScriptTrace
+
+#include <mutex>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "CPPScriptSignal.hpp"
+
+/**
+ * @brief Class of the built-in tracer of signal dispatch
+ *
+ * ScriptTrace::Start installs hooks recording when each fire and each
+ * function call begins and ends, in a lock-free ring buffer owned by
+ * the calling thread. ScriptTrace::Dump writes the records as a Chrome
+ * JSON trace, that can be opened in `chrome://tracing` or Perfetto
+ *
+ * @note When a thread records more than ScriptTrace::Capacity events,
+ * its oldest events are overwritten
+ */
+class ScriptTrace {
+public:
+	/** Number of events kept per thread, a power of two */
+	static constexpr std::size_t Capacity = 1 << 14;
+
+protected:
+	/** Struct of a recorded event */
+	struct Record {
+		/** Signal of the event */
+		const void* Signal;
+
+		/** Name of the signal, or `nullptr` */
+		const char* Name;
+
+		/** Slot of the called function, or ScriptTracer::Dispatch */
+		std::size_t Listener;
+
+		/** Time of the event, in nanoseconds of `std::chrono::steady_clock` */
+		std::int64_t Time;
+
+		/** `'B'` when the event begins and `'E'` when it ends */
+		char Phase;
+	};
+
+	/**
+	 * @brief Struct of the events recorded by a thread
+	 *
+	 * Only its thread writes the records, so recording is a store of
+	 * the record and a release store of ScriptTrace::Ring::Head
+	 */
+	struct Ring {
+		/** Identifier of the thread shown in the trace */
+		std::size_t Thread;
+
+		/** Number of events ever recorded */
+		std::atomic<std::uint64_t> Head{0};
+
+		/** The last ScriptTrace::Capacity events */
+		std::array<Record, Capacity> Records;
+	};
+
+	/** Struct of the rings of all threads that recorded an event */
+	struct Registry {
+		/** Access synchronization for Rings */
+		std::mutex Current;
+
+		/** Rings kept after their thread exits, so they can still be dumped */
+		std::vector<std::unique_ptr<Ring>> Rings;
+	};
+
+	/**
+	 * @brief Return the process registry of rings
+	 *
+	 * @return ScriptTrace::Registry&
+	 */
+	static Registry& Rings() {
+		static Registry Shared;
+		return Shared;
+	}
+
+	/**
+	 * @brief Return the ring of the current thread, registering it on its first event
+	 *
+	 * @return ScriptTrace::Ring&
+	 */
+	static Ring& Local() {
+		thread_local Ring* Own = nullptr;
+
+		if (!Own) [[unlikely]] {
+			Registry& Shared = Rings();
+			std::lock_guard<std::mutex> Hold(Shared.Current);
+			Shared.Rings.push_back(std::make_unique<Ring>());
+			Own = Shared.Rings.back().get();
+			Own->Thread = Shared.Rings.size();
+		}
+
+		return *Own;
+	}
+
+	/**
+	 * @brief Record an event in the ring of the current thread
+	 *
+	 * @param Signal Signal of the event
+	 * @param Name Name of the signal
+	 * @param Listener Slot of the called function, or ScriptTracer::Dispatch
+	 * @param Phase `'B'` or `'E'`
+	 */
+	static void Push(const void* Signal, const char* Name, std::size_t Listener, char Phase) {
+		Ring& Own = Local();
+		const std::uint64_t Head = Own.Head.load(std::memory_order_relaxed);
+		const auto Time = std::chrono::steady_clock::now().time_since_epoch();
+
+		Own.Records[Head & (Capacity - 1)] = {Signal, Name, Listener, std::chrono::duration_cast<std::chrono::nanoseconds>(Time).count(), Phase};
+		Own.Head.store(Head + 1, std::memory_order_release);
+	}
+
+	/** Hook called by ScriptTracer::Begin */
+	static void Begin(const void* Signal, const char* Name, std::size_t Listener) {
+		Push(Signal, Name, Listener, 'B');
+	}
+
+	/** Hook called by ScriptTracer::End */
+	static void End(const void* Signal, const char* Name, std::size_t Listener) {
+		Push(Signal, Name, Listener, 'E');
+	}
+
+	/**
+	 * @brief Write a string as a JSON string
+	 *
+	 * @param Stream Stream to be written
+	 * @param Text String to be escaped
+	 */
+	static void Quote(std::ostream& Stream, const char* Text) {
+		Stream << '"';
+
+		for (; *Text; ++Text) {
+			if (*Text == '"' || *Text == '\\') {
+				Stream << '\\' << *Text;
+			} else if (static_cast<unsigned char>(*Text) >= 0x20) {
+				Stream << *Text;
+			}
+		}
+
+		Stream << '"';
+	}
+
+public:
+	/** Install the hooks, so every signal records its dispatch */
+	static void Start() {
+		static constexpr ScriptTracer Hooks{&ScriptTrace::Begin, &ScriptTrace::End};
+		ScriptTracing.store(&Hooks, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Remove the hooks, nothing is recorded anymore
+	 *
+	 * @note A call already inside a hook may still record its event
+	 */
+	static void Stop() {
+		ScriptTracing.store(nullptr, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Forget every recorded event
+	 *
+	 * @note Must be called while tracing is stopped
+	 */
+	static void Clear() {
+		Registry& Shared = Rings();
+		std::lock_guard<std::mutex> Hold(Shared.Current);
+
+		for (auto& Own : Shared.Rings) {
+			Own->Head.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @brief Write the recorded events as a Chrome JSON trace
+	 *
+	 * Fires and function calls are named after their signal (or `Signal`
+	 * without a name), function calls have the connection's slot in their arguments
+	 *
+	 * @note Meant to be called while tracing is stopped, events recorded
+	 * during the dump may be written partially
+	 *
+	 * @param Stream Stream to be written, like a `std::ofstream`
+	 */
+	static void Dump(std::ostream& Stream) {
+		Registry& Shared = Rings();
+		std::lock_guard<std::mutex> Hold(Shared.Current);
+		bool First = true;
+
+		Stream << "{\"traceEvents\":[";
+
+		for (const auto& Own : Shared.Rings) {
+			const std::uint64_t Head = Own->Head.load(std::memory_order_acquire);
+
+			for (std::uint64_t Index = Head > Capacity ? Head - Capacity : 0; Index < Head; ++Index) {
+				const Record& Event = Own->Records[Index & (Capacity - 1)];
+
+				Stream << (First ? "\n" : ",\n") << "{\"name\":";
+				Quote(Stream, Event.Name ? Event.Name : "Signal");
+
+				if (Event.Listener == ScriptTracer::Dispatch) {
+					Stream << ",\"cat\":\"fire\"";
+				} else {
+					Stream << ",\"cat\":\"listener\"";
+				}
+
+				Stream << ",\"ph\":\"" << Event.Phase << "\",\"ts\":" << Event.Time / 1000 << '.' << (Event.Time % 1000) / 100 << (Event.Time % 100) / 10 << Event.Time % 10
+					<< ",\"pid\":1,\"tid\":" << Own->Thread << ",\"args\":{\"signal\":\"" << Event.Signal << '"';
+
+				if (Event.Listener != ScriptTracer::Dispatch) {
+					Stream << ",\"listener\":" << Event.Listener;
+				}
+
+				Stream << "}}";
+				First = false;
+			}
+		}
+
+		Stream << "\n]}\n";
+	}
+};
+
+#endif
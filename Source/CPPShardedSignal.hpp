@@ -0,0 +1,567 @@
+#ifndef CPPShardedSignal
+#define CPPShardedSignal
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "CPPConcurrentSignal.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Number of threads that fired any ShardedSignal, used to pick their shard
+ *
+ * @see ShardedThread
+ */
+inline std::atomic<unsigned> ShardedThreads{0};
+
+/**
+ * @brief Index of the current thread among the threads firing a ShardedSignal
+ *
+ * Given once per thread in round robin, so producers pinned to their
+ * cores keep their own shard
+ */
+inline thread_local const unsigned ShardedThread = ShardedThreads.fetch_add(1, std::memory_order_relaxed);
+
+/**
+ * @brief Class of signal fired by many threads at once, without shared writes
+ *
+ * Works as a ConcurrentSignal, but every shard (one per hardware thread
+ * by default) has its own cache line with its reader counters, its fire
+ * counter and its own replica of the snapshot. A fire only writes to the
+ * shard of its thread, and only reads the epoch, so firing threads never
+ * bounce a cache line between cores
+ *
+ * @note ShardedSignal::Wait makes each fire notify the shared waiting
+ * machinery while some thread is waiting
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class ShardedSignal {
+protected:
+	/** Function type of the listeners */
+	using Function = f_(ScriptArgument<Parameters>...);
+
+	/** Struct of a listener inside a snapshot */
+	struct Listener {
+		/** Unique identifier of the listener's connection */
+		std::uint64_t Id;
+
+		/** Function of the listener, shared by the replicas of the snapshot */
+		std::shared_ptr<const Function> Callback;
+	};
+
+	/** Immutable list of listeners read by ShardedSignal::Fire */
+	using Snapshot = std::vector<Listener>;
+
+public:
+	/**
+	 * @brief Struct of connection, a value handle to a listener
+	 *
+	 * Holds the signal and the listener's identifier only, so the signal
+	 * keeps nothing per connection and a disconnected listener leaves no
+	 * memory behind
+	 */
+	struct Connection {
+	protected:
+		/**
+		 * @brief Signal that owns the connection's function
+		 *
+		 * @see ShardedSignal::Connection::Disconnect
+		 */
+		ShardedSignal* Signal = nullptr;
+
+		/**
+		 * @brief Identifier of the connection's listener
+		 *
+		 * @see ShardedSignal::Listener::Id
+		 */
+		std::uint64_t Id = 0;
+
+	public:
+		/** Construct a connection that isn't connected to any signal */
+		Connection() = default;
+
+		/**
+		 * @brief Constructor of connection to direct initialize its handle
+		 *
+		 * @see ShardedSignal::Connect
+		 *
+		 * @param Owner Signal that holds the connection's function
+		 * @param Identifier Identifier of the connection's listener
+		 */
+		Connection(ShardedSignal* Owner, std::uint64_t Identifier) : Signal(Owner), Id(Identifier) {}
+
+		/**
+		 * @brief Return if connection's function exists or not
+		 *
+		 * @see ShardedSignal::Contains
+		 *
+		 * @return `true` if the listener is in the current snapshot
+		 */
+		inline bool Connected() const {
+			return Signal && Signal->Contains(Id);
+		}
+
+		/**
+		 * @brief Erase the connection's function from the signal
+		 *
+		 * @note Calling it again, or on a copy of a disconnected
+		 * connection, does nothing, even from many threads at once
+		 *
+		 * @see ShardedSignal::Erase
+		 */
+		void Disconnect() {
+			if (Signal) {
+				Signal->Erase(Id);
+			}
+		}
+	};
+
+protected:
+	/** Dispatch state of a shard, padded to its own cache line */
+	struct alignas(64) Shard {
+		/** Replica of the current snapshot read by the shard's threads */
+		std::atomic<const Snapshot*> Published{nullptr};
+
+		/** Number of ShardedSignal::Fire of the shard inside each epoch parity */
+		std::atomic<std::size_t> Readers[2] = {0, 0};
+
+		/** Number of fires made by the shard's threads */
+		std::atomic<std::uint64_t> Fires{0};
+	};
+
+	/**
+	 * @brief Dispatch state of every shard
+	 *
+	 * @see ShardedSignal::Local
+	 */
+	std::unique_ptr<Shard[]> Shards;
+
+	/** Number of shards, a power of two */
+	std::size_t Count;
+
+	/**
+	 * @brief Current epoch, its parity selects the reader counters
+	 *
+	 * Only written by ShardedSignal::Synchronize, so it stays shared
+	 * in the cache of every firing core
+	 *
+	 * @see ShardedSignal::Enter
+	 */
+	alignas(64) std::atomic<std::uint64_t> Epoch{0};
+
+	/**
+	 * @brief Number of threads in ShardedSignal::Wait, read by every fire
+	 *
+	 * @see ShardedSignal::Fire
+	 */
+	std::atomic<std::uint32_t> Watching{0};
+
+	/**
+	 * @brief Waiting machinery of ShardedSignal::Wait
+	 *
+	 * @see ShardedSignal::Fire
+	 * @see ShardedSignal::Wait
+	 */
+	alignas(64) ScriptWaiter Waiter;
+
+	/**
+	 * @brief Serialize the writers of the replicas
+	 *
+	 * @see ShardedSignal::Connect
+	 * @see ShardedSignal::Erase
+	 */
+	std::mutex Writing;
+
+	/**
+	 * @brief Serialize the epoch flips of ShardedSignal::Synchronize
+	 *
+	 * @note Separated from Writing, so a writer waiting for readers
+	 * never holds the lock that a firing reader might need
+	 */
+	std::mutex Reclaiming;
+
+	/**
+	 * @brief Replicas replaced but maybe still read by some Fire
+	 *
+	 * @see ShardedSignal::Publish
+	 */
+	std::vector<const Snapshot*> Retired;
+
+	/**
+	 * @brief Listeners of the current snapshot, copied by writers
+	 *
+	 * @see ShardedSignal::Publish
+	 */
+	Snapshot Current;
+
+	/**
+	 * @brief Identifier of the next connection
+	 *
+	 * @see ShardedSignal::Connect
+	 */
+	std::uint64_t Next = 0;
+
+	/**
+	 * @brief Return the shard of the current thread
+	 *
+	 * @return ShardedSignal::Shard&
+	 */
+	inline Shard& Local() {
+		return Shards[ShardedThread & (Count - 1)];
+	}
+
+	/**
+	 * @brief Register the current thread as a reader of the current epoch in its shard
+	 *
+	 * @see ConcurrentSignal::Enter
+	 *
+	 * @param Owner Shard of the current thread
+	 *
+	 * @return std::size_t Parity of the reader counter to be decreased
+	 */
+	std::size_t Enter(Shard& Owner) {
+		for (;;) {
+			const std::uint64_t Seen = Epoch.load();
+			std::atomic<std::size_t>& Readers = Owner.Readers[Seen & 1];
+
+			Readers.fetch_add(1);
+			if (Epoch.load() == Seen) {
+				return Seen & 1;
+			}
+
+			Readers.fetch_sub(1);
+		}
+	}
+
+	/**
+	 * @brief Wait until every reader active at the call has left, in all shards
+	 *
+	 * @see ConcurrentSignal::Synchronize
+	 */
+	void Synchronize() {
+		std::lock_guard<std::mutex> Hold(Reclaiming);
+
+		for (int Phase = 0; Phase < 2; ++Phase) {
+			const std::uint64_t Previous = Epoch.fetch_add(1);
+
+			for (std::size_t Index = 0; Index < Count; ++Index) {
+				while (Shards[Index].Readers[Previous & 1].load() != 0) {
+					std::this_thread::yield();
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Replace the replica of every shard by a copy of ShardedSignal::Current
+	 *
+	 * Must be called with Writing locked, that is released before
+	 * waiting for readers. If the current thread is firing a signal,
+	 * the replicas stay retired until the next writer outside of Fire
+	 *
+	 * @note Every replica is a separate allocation, so shards never share
+	 * the cache lines of their snapshots
+	 *
+	 * @param Lock Lock holding ShardedSignal::Writing
+	 */
+	void Publish(std::unique_lock<std::mutex>& Lock) {
+		for (std::size_t Index = 0; Index < Count; ++Index) {
+			Retired.push_back(Shards[Index].Published.exchange(new Snapshot(Current)));
+		}
+
+		if (ConcurrentDepth != 0) {
+			return;
+		}
+
+		std::vector<const Snapshot*> Reclaimed;
+		Reclaimed.swap(Retired);
+		Lock.unlock();
+
+		Synchronize();
+		for (const auto& Old : Reclaimed) {
+			delete Old;
+		}
+	}
+
+	/**
+	 * @brief Find a listener in a snapshot, listeners are sorted by identifier
+	 *
+	 * @see ConcurrentSignal::Find
+	 *
+	 * @param View Snapshot to be searched
+	 * @param Id Identifier of the listener
+	 *
+	 * @return Snapshot::const_iterator The listener, or the end of the snapshot
+	 */
+	static typename Snapshot::const_iterator Find(const Snapshot& View, std::uint64_t Id) {
+		const auto Found = std::lower_bound(View.begin(), View.end(), Id, [](const Listener& Entry, std::uint64_t Wanted) {
+			return Entry.Id < Wanted;
+		});
+
+		return Found != View.end() && Found->Id == Id ? Found : View.end();
+	}
+
+	/**
+	 * @brief Return if a listener is in the replica of the current thread's shard
+	 *
+	 * @see ShardedSignal::Connection::Connected
+	 *
+	 * @param Id Identifier of the listener
+	 *
+	 * @return bool
+	 */
+	bool Contains(std::uint64_t Id) {
+		Shard& Owner = Local();
+		Reading Guard(*this, Owner);
+		const Snapshot* View = Owner.Published.load(std::memory_order_acquire);
+		return Find(*View, Id) != View->end();
+	}
+
+	/**
+	 * @brief Publish replicas without a listener
+	 *
+	 * Nothing is published if the listener was already erased
+	 *
+	 * @see ShardedSignal::Connection::Disconnect
+	 *
+	 * @param Id Identifier of the listener to be erased
+	 */
+	void Erase(std::uint64_t Id) {
+		std::unique_lock<std::mutex> Lock(Writing);
+		const auto Erased = Find(Current, Id);
+
+		if (Erased == Current.end()) {
+			return;
+		}
+
+		Current.erase(Erased);
+		Publish(Lock);
+	}
+
+	/**
+	 * @brief Leaves the reader epoch when Fire returns or throws
+	 *
+	 * @see ShardedSignal::Fire
+	 */
+	struct Reading {
+		/** Counter to be decreased */
+		std::atomic<std::size_t>& Readers;
+
+		/** Enter a reader epoch of the shard */
+		Reading(ShardedSignal& Signal, Shard& Owner) : Readers(Owner.Readers[Signal.Enter(Owner)]) {
+			++ConcurrentDepth;
+		}
+
+		/** Leave the reader epoch */
+		~Reading() {
+			--ConcurrentDepth;
+			Readers.fetch_sub(1);
+		}
+	};
+
+	/**
+	 * @brief Counts a thread in ShardedSignal::Watching while it waits
+	 *
+	 * @see ShardedSignal::Wait
+	 */
+	struct Watch {
+		/** Signal being waited */
+		ShardedSignal& Signal;
+
+		/** Start making fires notify */
+		Watch(ShardedSignal& Owner) : Signal(Owner) {
+			Signal.Watching.fetch_add(1);
+		}
+
+		/** Stop waiting */
+		~Watch() {
+			Signal.Watching.fetch_sub(1);
+		}
+	};
+
+public:
+	/**
+	 * @brief Construct the signal with empty replicas
+	 *
+	 * @param Split Number of shards, rounded up to a power of two. `0`
+	 * makes one shard per hardware thread
+	 */
+	explicit ShardedSignal(std::size_t Split = 0) {
+		const std::size_t Wanted = Split ? Split : std::max(1u, std::thread::hardware_concurrency());
+
+		for (Count = 1; Count < Wanted; Count <<= 1) {}
+
+		Shards.reset(new Shard[Count]);
+		for (std::size_t Index = 0; Index < Count; ++Index) {
+			Shards[Index].Published.store(new Snapshot());
+		}
+	}
+
+	ShardedSignal(const ShardedSignal&) = delete;
+	ShardedSignal& operator=(const ShardedSignal&) = delete;
+
+	/**
+	 * @brief Delete all replicas and deconstruct Signal
+	 *
+	 * @note No thread may be firing the signal while it is deconstructed,
+	 * and its connections must not be used afterwards
+	 */
+	virtual ~ShardedSignal() {
+		for (const auto& Old : Retired) {
+			delete Old;
+		}
+
+		for (std::size_t Index = 0; Index < Count; ++Index) {
+			delete Shards[Index].Published.load();
+		}
+	}
+
+	/**
+	 * @brief Create a new connection and publish it's function to every shard
+	 *
+	 * @note Can be called from any thread, including from a listener
+	 *
+	 * @see ConcurrentSignal::Connect
+	 *
+	 * @param Listener Function or lambda to be used in connection
+	 *
+	 * @return ShardedSignal::Connection
+	 */
+	virtual Connection Connect(const Function& Listener) {
+		std::unique_lock<std::mutex> Lock(Writing);
+		Current.push_back({Next, std::make_shared<const Function>(Listener)});
+
+		const Connection New(this, Next++);
+		Publish(Lock);
+		return New;
+	}
+
+	/**
+	 * @brief Call all functions of the replica of the current thread's shard
+	 *
+	 * Only the shard's reader and fire counters are written, and the
+	 * shared waiting machinery is only notified while some thread waits
+	 *
+	 * @see ScriptArgument
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	virtual void Fire(ScriptArgument<Parameters>... Arguments) {
+		Shard& Owner = Local();
+
+		{
+			Reading Guard(*this, Owner);
+			const Snapshot* View = Owner.Published.load(std::memory_order_acquire);
+
+			if (View->empty()) {
+				return;
+			}
+
+			for (const auto& Entry : *View) {
+				(*Entry.Callback)(Arguments...);
+			}
+		}
+
+		Owner.Fires.fetch_add(1, std::memory_order_relaxed);
+
+		if (Watching.load() != 0) {
+			Waiter.Notify();
+		}
+	}
+
+	/**
+	 * @brief Return the number of shards
+	 *
+	 * @return std::size_t
+	 */
+	inline std::size_t Size() const {
+		return Count;
+	}
+
+	/**
+	 * @brief Return the number of fires made by the threads of a shard
+	 *
+	 * @note The count may be read while the shard's threads fire, it is
+	 * only exact once they stopped
+	 *
+	 * @param Index Index of the shard, below ShardedSignal::Size
+	 *
+	 * @return std::uint64_t
+	 */
+	inline std::uint64_t Fires(std::size_t Index) const {
+		return Shards[Index].Fires.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Return the number of fires made by all threads, summed over the shards
+	 *
+	 * @return std::uint64_t
+	 */
+	std::uint64_t Fires() const {
+		std::uint64_t Total = 0;
+
+		for (std::size_t Index = 0; Index < Count; ++Index) {
+			Total += Fires(Index);
+		}
+
+		return Total;
+	}
+
+	/**
+	 * @brief Wait for ShardedSignal::Fire to be called and return elapsed time
+	 *
+	 * @note Fires are only notified while some thread waits, a fire
+	 * running its functions when the wait starts may not wake it
+	 *
+	 * @see ScriptWaiter::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for ShardedSignal::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		Watch Guard(*this);
+		return Waiter.Wait();
+	}
+
+	/**
+	 * @brief Wait for ShardedSignal::Fire to be called for a duration
+	 *
+	 * @see ScriptWaiter::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		Watch Guard(*this);
+		return Waiter.WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for ShardedSignal::Fire to be called until a time point
+	 *
+	 * @see ScriptWaiter::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		Watch Guard(*this);
+		return Waiter.WaitUntil(Time);
+	}
+};
+
+#undef f_
+#endif
@@ -0,0 +1,502 @@
+#ifndef CPPSharedSignal
+#define CPPSharedSignal
+
+#if !defined(__linux__)
+#error "CPPSharedSignal.hpp needs Linux shared memory and futexes"
+#endif
+
+#include <array>
+#include <tuple>
+#include <cerrno>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <climits>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "CPPScriptSignal.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Class of signal bridging processes through a shared memory ring
+ *
+ * Every process opening the same name maps the same ring. SharedSignal::Post,
+ * from any thread of any process, copies the arguments in the next cell
+ * of the ring. Each process then calls SharedSignal::Drain to fire its
+ * local functions with every fire posted since its last drain, in
+ * posting order, and SharedSignal::WaitPosted blocks on a futex shared
+ * between the processes until something is posted
+ *
+ * The arguments are copied bytes, so no serialization happens: a post
+ * is a claim of the cell, two copies of the payload and a wake up call
+ * made only when some process is blocked
+ *
+ * @note The ring is a broadcast: a process that drains too slowly is
+ * lapped, the fires overwritten are skipped and counted by SharedSignal::Lost
+ *
+ * @note A process killed in the middle of a post leaves its cell
+ * unpublished, posts to that cell one lap later then block
+ *
+ * @tparam Parameters The parameters to be used in function of connection, trivially copyable
+ */
+template <typename... Parameters> class SharedSignal final : public ScriptSignalBase<SharedSignal<Parameters...>, f_(ScriptArgument<Parameters>...), Parameters...> {
+	static_assert((std::is_trivially_copyable_v<std::decay_t<Parameters>> && ...), "SharedSignal parameters must be trivially copyable");
+
+protected:
+	/** Base class holding the implementation */
+	using Base = ScriptSignalBase<SharedSignal, f_(ScriptArgument<Parameters>...), Parameters...>;
+
+	/** Marks a ring whose control block is initialized */
+	static constexpr std::uint32_t Magic = 0x53494731;
+
+	/** Number of parameters */
+	static constexpr std::size_t Count = sizeof...(Parameters);
+
+	/** Offset of each argument in a payload, then the payload's end */
+	static constexpr std::array<std::size_t, Count + 1> Offsets = [] {
+		std::array<std::size_t, Count + 1> Result{};
+		std::size_t Offset = 0;
+		std::size_t Index = 0;
+		((Offset = (Offset + alignof(std::decay_t<Parameters>) - 1) / alignof(std::decay_t<Parameters>) * alignof(std::decay_t<Parameters>),
+			Result[Index++] = Offset, Offset += sizeof(std::decay_t<Parameters>)), ...);
+		Result[Count] = Offset;
+		return Result;
+	}();
+
+	/** Size of a payload, at least one byte */
+	static constexpr std::size_t Size = std::max<std::size_t>(Offsets[Count], 1);
+
+	/** Hash of the size and alignment of every parameter, to check the ring's parameters */
+	static constexpr std::uint64_t Layout = [] {
+		std::uint64_t Hash = 14695981039346656037ull;
+		((Hash = (Hash ^ sizeof(std::decay_t<Parameters>)) * 1099511628211ull, Hash = (Hash ^ alignof(std::decay_t<Parameters>)) * 1099511628211ull), ...);
+		return (Hash ^ Count) * 1099511628211ull;
+	}();
+
+	/** Alignment of a payload */
+	static constexpr std::size_t Alignment = std::max({alignof(std::uint64_t), alignof(std::decay_t<Parameters>)...});
+
+	/** Control block at the start of the shared memory */
+	struct Control {
+		/** SharedSignal::Magic once the block is initialized */
+		std::atomic<std::uint32_t> Ready;
+
+		/** Number of cells, a power of two */
+		std::uint32_t Capacity;
+
+		/** Size of a cell, checked by every process opening the ring */
+		std::uint32_t Stride;
+
+		/** SharedSignal::Layout of the creator, checked by every process opening the ring */
+		std::uint64_t Signature;
+
+		/** Number of posts ever claimed */
+		alignas(64) std::atomic<std::uint64_t> Head;
+
+		/** Number of posts published, the futex word of the waiters */
+		alignas(64) std::atomic<std::uint32_t> Generation;
+
+		/** Number of threads blocked, in any process */
+		std::atomic<std::uint32_t> Waiters;
+	};
+
+	/** Cell of the ring, on its own cache line */
+	struct alignas(64) Cell {
+		/**
+		 * @brief `2 * (Post + 1)` once the post is published, odd while it is written
+		 *
+		 * @see SharedSignal::Post
+		 */
+		std::atomic<std::uint64_t> Stamp;
+
+		/** Bytes of the arguments, at SharedSignal::Offsets */
+		alignas(Alignment) unsigned char Payload[Size];
+	};
+
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free, "SharedSignal needs address-free atomics");
+
+	/** Mapped control block */
+	Control* Shared = nullptr;
+
+	/** Mapped cells, after the control block */
+	Cell* Cells = nullptr;
+
+	/** Size of the mapping */
+	std::size_t Length = 0;
+
+	/** Number of cells minus one */
+	std::uint64_t Mask = 0;
+
+	/**
+	 * @brief Next post to be drained by this process
+	 *
+	 * @see SharedSignal::Drain
+	 */
+	std::uint64_t Cursor = 0;
+
+	/**
+	 * @brief Number of posts this process missed because it was lapped
+	 *
+	 * @see SharedSignal::Lost
+	 */
+	std::uint64_t Missed = 0;
+
+	/** Times the ring is checked before blocking */
+	std::uint32_t Spins = 128;
+
+	/**
+	 * @brief Map the ring of a name, creating and initializing it if it doesn't exist
+	 *
+	 * @param Name Name of the shared memory object, like `"/hits"`
+	 * @param Requested Number of cells, rounded up to a power of two, used by the creator only
+	 */
+	void Open(const char* Name, std::size_t Requested) {
+		std::uint32_t Capacity = 1;
+		while (Capacity < Requested) {
+			Capacity <<= 1;
+		}
+
+		bool Created = true;
+		int Handle = shm_open(Name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+		if (Handle < 0 && errno == EEXIST) {
+			Created = false;
+			Handle = shm_open(Name, O_RDWR, 0600);
+		}
+
+		if (Handle < 0) {
+			throw std::system_error(errno, std::generic_category(), "shm_open");
+		}
+
+		struct Closing {
+			/** Descriptor closed once mapped, or on error */
+			int Handle;
+
+			~Closing() {
+				close(Handle);
+			}
+		} Guard{Handle};
+
+		if (Created) {
+			Length = sizeof(Control) + Capacity * sizeof(Cell);
+
+			if (ftruncate(Handle, static_cast<off_t>(Length)) != 0) {
+				const int Error = errno;
+				shm_unlink(Name);
+				throw std::system_error(Error, std::generic_category(), "ftruncate");
+			}
+		} else {
+			struct stat Status;
+
+			do {
+				if (fstat(Handle, &Status) != 0) {
+					throw std::system_error(errno, std::generic_category(), "fstat");
+				}
+
+				std::this_thread::yield();
+			} while (Status.st_size == 0);
+
+			Length = static_cast<std::size_t>(Status.st_size);
+		}
+
+		void* Region = mmap(nullptr, Length, PROT_READ | PROT_WRITE, MAP_SHARED, Handle, 0);
+
+		if (Region == MAP_FAILED) {
+			throw std::system_error(errno, std::generic_category(), "mmap");
+		}
+
+		Shared = static_cast<Control*>(Region);
+		Cells = reinterpret_cast<Cell*>(static_cast<unsigned char*>(Region) + sizeof(Control));
+
+		if (Created) {
+			Shared->Capacity = Capacity;
+			Shared->Stride = sizeof(Cell);
+			Shared->Signature = Layout;
+			Shared->Ready.store(Magic, std::memory_order_release);
+		} else {
+			while (Shared->Ready.load(std::memory_order_acquire) != Magic) {
+				std::this_thread::yield();
+			}
+
+			if (Shared->Stride != sizeof(Cell) || Shared->Signature != Layout || Length != sizeof(Control) + std::size_t(Shared->Capacity) * sizeof(Cell)) {
+				munmap(Region, Length);
+				throw std::system_error(EINVAL, std::generic_category(), "SharedSignal parameters differ from the ring's");
+			}
+		}
+
+		Mask = Shared->Capacity - 1;
+		Cursor = Shared->Head.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Return if the post at the cursor is published
+	 *
+	 * @return bool
+	 */
+	inline bool Pending() const {
+		return Cells[Cursor & Mask].Stamp.load(std::memory_order_acquire) >= 2 * (Cursor + 1);
+	}
+
+	/**
+	 * @brief Copy the arguments in a payload
+	 *
+	 * @param Payload Bytes of the payload
+	 * @param Arguments Arguments to be copied
+	 */
+	template <std::size_t... Indexes> static void Store([[maybe_unused]] unsigned char* Payload, std::index_sequence<Indexes...>, ScriptArgument<Parameters>... Arguments) {
+		(std::memcpy(Payload + Offsets[Indexes], &Arguments, sizeof(std::decay_t<Parameters>)), ...);
+	}
+
+	/**
+	 * @brief Fire the local functions with the arguments of a payload
+	 *
+	 * @param Payload Bytes of a payload copied out of the ring
+	 */
+	template <std::size_t... Indexes> void Dispatch([[maybe_unused]] const unsigned char* Payload, std::index_sequence<Indexes...>) {
+		this->Fire(*std::launder(reinterpret_cast<const std::decay_t<Parameters>*>(Payload + Offsets[Indexes]))...);
+	}
+
+	/**
+	 * @brief Block on the shared futex while it is Seen, or until Deadline
+	 *
+	 * @param Seen Generation captured by the waiter
+	 * @param Deadline Time to stop waiting, or `nullptr`
+	 */
+	void Park(std::uint32_t Seen, const std::chrono::steady_clock::time_point* Deadline) {
+		timespec Timeout;
+		timespec* Limit = nullptr;
+
+		if (Deadline) {
+			const auto Left = std::chrono::duration_cast<std::chrono::nanoseconds>(*Deadline - std::chrono::steady_clock::now()).count();
+
+			if (Left <= 0) {
+				return;
+			}
+
+			Timeout.tv_sec = static_cast<time_t>(Left / 1000000000);
+			Timeout.tv_nsec = static_cast<long>(Left % 1000000000);
+			Limit = &Timeout;
+		}
+
+		syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Shared->Generation), FUTEX_WAIT, Seen, Limit, nullptr, 0);
+	}
+
+	/**
+	 * @brief Wait for a post to drain, or until Deadline
+	 *
+	 * @see ScriptWaiter::Block
+	 *
+	 * @param Deadline Time to stop waiting, or `nullptr` to wait forever
+	 *
+	 * @return `true` if a post is ready to be drained
+	 */
+	bool Await(const std::chrono::steady_clock::time_point* Deadline) {
+		for (std::uint32_t Count = 0; Count < Spins; ++Count) {
+			if (Pending()) {
+				return true;
+			}
+
+#if defined(__x86_64__) || defined(__i386__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			asm volatile("yield");
+#endif
+		}
+
+		Shared->Waiters.fetch_add(1);
+		bool Ready = false;
+
+		for (;;) {
+			const std::uint32_t Seen = Shared->Generation.load();
+
+			if ((Ready = Pending()) || (Deadline && std::chrono::steady_clock::now() >= *Deadline)) {
+				break;
+			}
+
+			Park(Seen, Deadline);
+		}
+
+		Shared->Waiters.fetch_sub(1);
+		return Ready;
+	}
+
+public:
+	/** Connection returned by SharedSignal::Connect */
+	using typename Base::Connection;
+
+	/**
+	 * @brief Map the ring of a name, creating it if no process did
+	 *
+	 * The process only drains the fires posted after it opened the ring.
+	 * Throws `std::system_error` if the ring can't be mapped, or if it
+	 * was created with other parameters
+	 *
+	 * @param Name Name of the shared memory object, like `"/hits"`
+	 * @param Capacity Number of cells when the ring is created, rounded up to a power of two
+	 */
+	explicit SharedSignal(const char* Name, std::size_t Capacity = 1024) {
+		Open(Name, Capacity);
+	}
+
+	SharedSignal(const SharedSignal&) = delete;
+	SharedSignal& operator=(const SharedSignal&) = delete;
+
+	/**
+	 * @brief Unmap the ring, that stays for the other processes
+	 *
+	 * @see SharedSignal::Remove
+	 */
+	~SharedSignal() {
+		munmap(Shared, Length);
+	}
+
+	/**
+	 * @brief Remove the name of a ring, mapped rings stay until unmapped
+	 *
+	 * @param Name Name of the shared memory object
+	 */
+	static void Remove(const char* Name) {
+		shm_unlink(Name);
+	}
+
+	/**
+	 * @brief Post a fire to every process draining the ring
+	 *
+	 * The post claims a cell with a single fetch-and-add, waits if the
+	 * post of the previous lap is still being written there, copies
+	 * the arguments and publishes the cell's stamp, then wakes the
+	 * blocked processes, if any
+	 *
+	 * @note Can be called from any thread of any process
+	 *
+	 * @param Arguments Arguments in base of Signal's parameters
+	 */
+	void Post(ScriptArgument<Parameters>... Arguments) {
+		const std::uint64_t Index = Shared->Head.fetch_add(1, std::memory_order_acq_rel);
+		Cell& Target = Cells[Index & Mask];
+
+		if (Index > Mask) {
+			const std::uint64_t Previous = 2 * (Index - Mask);
+
+			while (Target.Stamp.load(std::memory_order_acquire) < Previous) {
+				std::this_thread::yield();
+			}
+		}
+
+		Target.Stamp.store(2 * Index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Store(Target.Payload, std::index_sequence_for<Parameters...>(), Arguments...);
+		Target.Stamp.store(2 * Index + 2, std::memory_order_release);
+
+		Shared->Generation.fetch_add(1);
+
+		if (Shared->Waiters.load() != 0) {
+			syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&Shared->Generation), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+		}
+	}
+
+	/**
+	 * @brief Fire the local functions with every post since the last drain, in posting order
+	 *
+	 * Each payload is copied out of its cell and checked against the
+	 * cell's stamp, so a post overwritten while being copied is skipped
+	 *
+	 * @note Must be called by a single thread of the process
+	 *
+	 * @return std::size_t Number of posts dispatched
+	 */
+	std::size_t Drain() {
+		alignas(Alignment) unsigned char Local[Size];
+		std::size_t Dispatched = 0;
+
+		for (;;) {
+			Cell& Target = Cells[Cursor & Mask];
+			const std::uint64_t Expected = 2 * (Cursor + 1);
+			const std::uint64_t Stamp = Target.Stamp.load(std::memory_order_acquire);
+
+			if (Stamp < Expected) {
+				break;
+			}
+
+			if (Stamp == Expected) {
+				std::memcpy(Local, Target.Payload, Size);
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (Target.Stamp.load(std::memory_order_relaxed) == Expected) {
+					++Cursor;
+					++Dispatched;
+					Dispatch(Local, std::index_sequence_for<Parameters...>());
+					continue;
+				}
+			}
+
+			const std::uint64_t Oldest = Shared->Head.load(std::memory_order_acquire) - Mask - 1;
+			Missed += Oldest - Cursor;
+			Cursor = Oldest;
+		}
+
+		return Dispatched;
+	}
+
+	/**
+	 * @brief Block until a post is ready to be drained
+	 *
+	 * Spins for a short while, then blocks on the futex shared by the processes
+	 *
+	 * @see SharedSignal::Drain
+	 */
+	void WaitPosted() {
+		Await(nullptr);
+	}
+
+	/**
+	 * @brief Block until a post is ready to be drained, for a duration
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return `true` if a post is ready, `false` if it timed out
+	 */
+	template <typename Representation, typename Period> bool WaitPosted(const std::chrono::duration<Representation, Period>& Timeout) {
+		const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(Timeout);
+		return Await(&Deadline);
+	}
+
+	/**
+	 * @brief Return the number of posts this process skipped because it was lapped
+	 *
+	 * @return std::uint64_t
+	 */
+	inline std::uint64_t Lost() const {
+		return Missed;
+	}
+
+	/**
+	 * @brief Set how many times SharedSignal::WaitPosted checks the ring before blocking
+	 *
+	 * @param Count Times to spin, `0` blocks right away
+	 */
+	void Spin(std::uint32_t Count) {
+		Spins = Count;
+	}
+};
+
+#undef f_
+#endif
@@ -0,0 +1,115 @@
+#ifndef CPPStaticSignal
+#define CPPStaticSignal
+
+#include <tuple>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <optional>
+
+#include "CPPScriptSignal.hpp"
+
+/**
+ * @brief Class of signal with a fixed set of listeners known at compile time
+ *
+ * The listeners are held by value in a `std::tuple`, without type erasure
+ * or virtual calls, and StaticSignal::Fire calls them with a fold
+ * expression, so the compiler can inline every listener in the fire
+ *
+ * @tparam Listeners The types of the functions or lambdas to be called
+ */
+template <typename... Listeners> class StaticSignal {
+protected:
+	/**
+	 * @brief All listeners, called in order
+	 *
+	 * @see StaticSignal::Fire
+	 */
+	std::tuple<Listeners...> Functions;
+
+	/**
+	 * @brief Waiting machinery of StaticSignal::Wait
+	 *
+	 * @see StaticSignal::Fire
+	 * @see StaticSignal::Wait
+	 */
+	ScriptWaiter Waiter;
+
+public:
+	/**
+	 * @brief Construct the signal holding its listeners
+	 *
+	 * @param Function Functions or lambdas to be called by StaticSignal::Fire
+	 */
+	explicit StaticSignal(Listeners... Function) : Functions(std::move(Function)...) {}
+
+	/**
+	 * @brief Call all listeners with the given arguments
+	 *
+	 * The arguments are passed to every listener as lvalues, so
+	 * nothing is copied or moved between listeners
+	 *
+	 * @see ScriptWaiter::Notify
+	 *
+	 * @param Arguments Arguments to be passed to every listener
+	 */
+	template <typename... Values> void Fire(Values&&... Arguments) {
+		if constexpr (sizeof...(Listeners) != 0) {
+			std::apply([&](auto&... Function) { (Function(Arguments...), ...); }, Functions);
+			Waiter.Notify();
+		}
+	}
+
+	/**
+	 * @brief Wait for StaticSignal::Fire to be called and return elapsed time
+	 *
+	 * @see ScriptWaiter::Wait
+	 *
+	 * @return std::chrono::nanoseconds Elapsed time to wait for StaticSignal::Fire to be called
+	 */
+	std::chrono::nanoseconds Wait() {
+		return Waiter.Wait();
+	}
+
+	/**
+	 * @brief Wait for StaticSignal::Fire to be called for a duration
+	 *
+	 * @see ScriptWaiter::WaitFor
+	 *
+	 * @param Timeout Longest time to wait
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Representation, typename Period> std::optional<std::chrono::nanoseconds> WaitFor(const std::chrono::duration<Representation, Period>& Timeout) {
+		return Waiter.WaitFor(Timeout);
+	}
+
+	/**
+	 * @brief Wait for StaticSignal::Fire to be called until a time point
+	 *
+	 * @see ScriptWaiter::WaitUntil
+	 *
+	 * @param Time Time point to stop waiting, in any clock
+	 *
+	 * @return std::optional<std::chrono::nanoseconds> Elapsed time, or empty if it timed out
+	 */
+	template <typename Source, typename Duration> std::optional<std::chrono::nanoseconds> WaitUntil(const std::chrono::time_point<Source, Duration>& Time) {
+		return Waiter.WaitUntil(Time);
+	}
+
+	/**
+	 * @brief Set how many times StaticSignal::Wait checks for a fire before parking
+	 *
+	 * @see ScriptWaiter::Spin
+	 *
+	 * @param Count Times to spin, `0` parks right away
+	 */
+	void Spin(std::uint32_t Count) {
+		Waiter.Spin(Count);
+	}
+};
+
+/** Deduce the listener types from the constructor, as in `StaticSignal Signal(First, Second)` */
+template <typename... Listeners> StaticSignal(Listeners...) -> StaticSignal<Listeners...>;
+
+#endif
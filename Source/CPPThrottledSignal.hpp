@@ -0,0 +1,576 @@
+#ifndef CPPThrottledSignal
+#define CPPThrottledSignal
+
+#include <tuple>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
+
+#include "CPPScriptSignal.hpp"
+#include "CPPScriptDelegate.hpp"
+
+/** Alias for the default function type to be used */
+#define f_(X) std::function<void(X)>
+
+/**
+ * @brief Class of hashed timer wheel shared by many timed adapters
+ *
+ * Timers are intrusive nodes linked in the bucket of their deadline's
+ * tick, so scheduling, rescheduling and cancelling are O(1) and never
+ * allocate. No thread is started: the owner calls
+ * ScriptTimerWheel::Advance from its loop, and each elapsed tick only
+ * visits its own bucket, whatever the number of timers
+ *
+ * @note Not thread-safe, timers are scheduled and expired by the
+ * thread calling ScriptTimerWheel::Advance
+ */
+class ScriptTimerWheel {
+public:
+	/** Clock of the deadlines */
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Struct of a timer, embedded in the object it calls back
+	 *
+	 * @see ScriptTimerWheel::Schedule
+	 */
+	struct Timer {
+	protected:
+		friend ScriptTimerWheel;
+
+		/** Wheel the timer is scheduled in, or `nullptr` */
+		ScriptTimerWheel* Wheel = nullptr;
+
+		/** List the timer is linked in, or `nullptr` */
+		Timer** Head = nullptr;
+
+		/** Timer linked before this one */
+		Timer* Previous = nullptr;
+
+		/** Timer linked after this one */
+		Timer* Next = nullptr;
+
+		/** Tick of the deadline */
+		std::uint64_t Deadline = 0;
+
+		/** Called when the deadline is reached */
+		void (*Expire)(void*);
+
+		/** Passed to Expire */
+		void* Context;
+
+	public:
+		/**
+		 * @brief Construct an unscheduled timer
+		 *
+		 * @param Callback Called with Owner when the timer expires
+		 * @param Owner Object of the timer
+		 */
+		Timer(void (*Callback)(void*), void* Owner) : Expire(Callback), Context(Owner) {}
+
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+		/** Cancel the timer if it is scheduled */
+		~Timer() {
+			if (Wheel) {
+				Wheel->Cancel(*this);
+			}
+		}
+
+		/**
+		 * @brief Return if the timer is scheduled
+		 *
+		 * @return bool
+		 */
+		inline bool Scheduled() const {
+			return Head != nullptr;
+		}
+	};
+
+protected:
+	/** Duration of a tick */
+	Clock::duration Resolution;
+
+	/** Time of tick 0 */
+	Clock::time_point Origin;
+
+	/** Last tick whose bucket was visited */
+	std::uint64_t Current = 0;
+
+	/** Number of buckets minus one, the bucket count being a power of two */
+	std::size_t Mask;
+
+	/** Timers by the tick of their deadline, modulo the bucket count */
+	std::vector<Timer*> Buckets;
+
+	/**
+	 * @brief Timers of the visited bucket that reached their deadline
+	 *
+	 * A list of the wheel, so a callback can cancel another timer that is about to expire
+	 */
+	Timer* Expiring = nullptr;
+
+	/**
+	 * @brief Return the tick of a time point
+	 *
+	 * @param Time Time point after the wheel's construction
+	 *
+	 * @return std::uint64_t
+	 */
+	inline std::uint64_t Tick(Clock::time_point Time) const {
+		return static_cast<std::uint64_t>((Time - Origin) / Resolution);
+	}
+
+	/**
+	 * @brief Link a timer at the front of a list
+	 *
+	 * @param List Head of the list
+	 * @param Node Timer to be linked
+	 */
+	static void Link(Timer*& List, Timer& Node) {
+		Node.Head = &List;
+		Node.Previous = nullptr;
+		Node.Next = List;
+
+		if (List) {
+			List->Previous = &Node;
+		}
+
+		List = &Node;
+	}
+
+	/**
+	 * @brief Unlink a timer from its list
+	 *
+	 * @param Node Linked timer
+	 */
+	static void Unlink(Timer& Node) {
+		if (Node.Previous) {
+			Node.Previous->Next = Node.Next;
+		} else {
+			*Node.Head = Node.Next;
+		}
+
+		if (Node.Next) {
+			Node.Next->Previous = Node.Previous;
+		}
+
+		Node.Head = nullptr;
+	}
+
+	/**
+	 * @brief Expire the timers of a bucket whose deadline is at most Limit
+	 *
+	 * @param Bucket Bucket to be visited
+	 * @param Limit Last elapsed tick
+	 *
+	 * @return std::size_t Number of expired timers
+	 */
+	std::size_t Visit(Timer*& Bucket, std::uint64_t Limit) {
+		for (Timer* Node = Bucket; Node;) {
+			Timer* Next = Node->Next;
+
+			if (Node->Deadline <= Limit) {
+				Unlink(*Node);
+				Link(Expiring, *Node);
+			}
+
+			Node = Next;
+		}
+
+		std::size_t Expired = 0;
+		while (Expiring) {
+			Timer& Node = *Expiring;
+			Unlink(Node);
+			Node.Wheel = nullptr;
+			Node.Expire(Node.Context);
+			++Expired;
+		}
+
+		return Expired;
+	}
+
+public:
+	/**
+	 * @brief Construct the wheel
+	 *
+	 * @param Step Duration of a tick, the precision of the deadlines
+	 * @param Count Number of buckets, rounded up to a power of two. A
+	 * deadline further than Count ticks stays in its bucket for more turns
+	 */
+	explicit ScriptTimerWheel(Clock::duration Step = std::chrono::milliseconds(1), std::size_t Count = 256) : Resolution(Step), Origin(Clock::now()) {
+		std::size_t Size = 1;
+		while (Size < Count) {
+			Size <<= 1;
+		}
+
+		Mask = Size - 1;
+		Buckets.assign(Size, nullptr);
+	}
+
+	ScriptTimerWheel(const ScriptTimerWheel&) = delete;
+	ScriptTimerWheel& operator=(const ScriptTimerWheel&) = delete;
+
+	/**
+	 * @brief Unschedule every timer left
+	 *
+	 * @note The timers must not be used after the wheel is deconstructed
+	 */
+	~ScriptTimerWheel() {
+		for (auto& Bucket : Buckets) {
+			while (Bucket) {
+				Bucket->Wheel = nullptr;
+				Unlink(*Bucket);
+			}
+		}
+	}
+
+	/**
+	 * @brief Schedule a timer, or reschedule it if it is already scheduled
+	 *
+	 * @note The deadline is rounded up to the next tick, so a timer
+	 * never expires in the ScriptTimerWheel::Advance scheduling it
+	 *
+	 * @param Node Timer to be scheduled
+	 * @param Delay Time from now to the deadline
+	 */
+	void Schedule(Timer& Node, Clock::duration Delay) {
+		if (Node.Head) {
+			Unlink(Node);
+		}
+
+		const std::uint64_t Ticks = static_cast<std::uint64_t>((Delay + Resolution - Clock::duration(1)) / Resolution);
+		Node.Wheel = this;
+		Node.Deadline = std::max(Tick(Clock::now()), Current) + std::max<std::uint64_t>(Ticks, 1);
+		Link(Buckets[Node.Deadline & Mask], Node);
+	}
+
+	/**
+	 * @brief Unschedule a timer, if it is scheduled
+	 *
+	 * @param Node Timer to be cancelled
+	 */
+	void Cancel(Timer& Node) {
+		if (Node.Head) {
+			Unlink(Node);
+		}
+
+		Node.Wheel = nullptr;
+	}
+
+	/**
+	 * @brief Expire the timers whose deadline elapsed
+	 *
+	 * Visits the bucket of each tick elapsed since the last call, or
+	 * every bucket once if more ticks than buckets elapsed
+	 *
+	 * @note A callback can schedule and cancel any timer, including its own
+	 *
+	 * @param Now Current time
+	 *
+	 * @return std::size_t Number of expired timers
+	 */
+	std::size_t Advance(Clock::time_point Now = Clock::now()) {
+		const std::uint64_t Limit = Tick(Now);
+		std::size_t Expired = 0;
+
+		if (Limit <= Current) {
+			return 0;
+		}
+
+		if (Limit - Current > Mask) {
+			Current = Limit;
+
+			for (auto& Bucket : Buckets) {
+				Expired += Visit(Bucket, Limit);
+			}
+
+			return Expired;
+		}
+
+		while (Current < Limit) {
+			++Current;
+			Expired += Visit(Buckets[Current & Mask], Current);
+		}
+
+		return Expired;
+	}
+};
+
+/**
+ * @brief Base class of the signals fired by an adapter of another signal
+ *
+ * The most derived adapter connects to the source at the end of its
+ * constructor, once its members are built, and the adapter disconnects
+ * on deconstruction. Each fire of the source goes to `Derived::Receive`,
+ * which decides when the adapter fires its own functions
+ *
+ * @note The source must outlive the adapter: the adapter's destructor
+ * disconnects through the source's connection, which dangles once the
+ * source is deconstructed. Declare the adapter after its source, or
+ * destroy it first
+ *
+ * @tparam Derived The adapter deriving from this class
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename Derived, typename... Parameters> class ScriptAdapter : public ScriptSignalBase<Derived, f_(ScriptArgument<Parameters>...), Parameters...> {
+protected:
+	/** Base class holding the implementation */
+	using Base = ScriptSignalBase<Derived, f_(ScriptArgument<Parameters>...), Parameters...>;
+
+	/** Copy of the arguments of a fire */
+	using typename Base::Event;
+
+	/**
+	 * @brief Disconnect the adapter from its source
+	 *
+	 * @note Holds the source's connection inline, so building an adapter
+	 * never allocates for it (a connection that doesn't fit is a compile
+	 * error)
+	 *
+	 * @see ScriptAdapter::~ScriptAdapter
+	 */
+	InlineDelegate<void()> Release;
+
+	/** Construct an adapter that isn't connected yet */
+	ScriptAdapter() = default;
+
+	/**
+	 * @brief Connect the adapter to its source
+	 *
+	 * @note Called by the most derived constructor once its members are
+	 * built, so a fire of the source never reaches a half built adapter.
+	 * The source must outlive the adapter
+	 *
+	 * @tparam Signal Type of the source, a signal whose connection is returned by value
+	 *
+	 * @param Source Signal adapted
+	 */
+	template <typename Signal> void Listen(Signal& Source) {
+		auto Input = Source.Connect([this](ScriptArgument<Parameters>... Arguments) {
+			static_cast<Derived*>(this)->Receive(Arguments...);
+		});
+
+		Release = [Input]() mutable {
+			Input.Disconnect();
+		};
+	}
+
+	/**
+	 * @brief Fire the adapter with a copy of the arguments of a fire
+	 *
+	 * @param Arguments Arguments to be passed to the functions
+	 */
+	void Emit(Event& Arguments) {
+		std::apply([this](auto&... Values) { this->Fire(Values...); }, Arguments);
+	}
+
+public:
+	ScriptAdapter(const ScriptAdapter&) = delete;
+	ScriptAdapter& operator=(const ScriptAdapter&) = delete;
+
+	/** Disconnect from the source */
+	~ScriptAdapter() {
+		if (Release) {
+			Release();
+		}
+	}
+};
+
+/**
+ * @brief Class of signal firing at most once per interval of its source
+ *
+ * The first fire of the source is passed at once and starts the
+ * interval. The source's fires during the interval overwrite a single
+ * pending copy, fired when the interval ends (starting a new one), so
+ * the last value is never lost
+ *
+ * @code
+ * ScriptTimerWheel Wheel;
+ * ThrottledSignal<Vector> Moved(Mouse, Wheel, std::chrono::milliseconds(16));
+ * Moved.Connect(Redraw);
+ * @endcode
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class ThrottledSignal final : public ScriptAdapter<ThrottledSignal<Parameters...>, Parameters...> {
+protected:
+	friend ScriptAdapter<ThrottledSignal, Parameters...>;
+
+	/** Base class connecting to the source */
+	using Adapter = ScriptAdapter<ThrottledSignal, Parameters...>;
+
+	/** Copy of the arguments of a fire */
+	using typename Adapter::Event;
+
+	/** Wheel of the interval's timer */
+	ScriptTimerWheel& Wheel;
+
+	/** Minimum time between two fires */
+	ScriptTimerWheel::Clock::duration Interval;
+
+	/** Last fire of the source during the interval */
+	std::optional<Event> Latest;
+
+	/** Ends the interval */
+	ScriptTimerWheel::Timer Cooldown{&ThrottledSignal::Expire, this};
+
+	/**
+	 * @brief Fire at once outside of an interval, keep the arguments otherwise
+	 *
+	 * @param Arguments Arguments of the source's fire
+	 */
+	void Receive(ScriptArgument<Parameters>... Arguments) {
+		if (Cooldown.Scheduled()) {
+			Latest.emplace(Arguments...);
+			return;
+		}
+
+		Wheel.Schedule(Cooldown, Interval);
+		this->Fire(Arguments...);
+	}
+
+	/** Fire the kept arguments and start a new interval, or end the interval */
+	static void Expire(void* Owner) {
+		ThrottledSignal& Self = *static_cast<ThrottledSignal*>(Owner);
+
+		if (Self.Latest) {
+			Event Arguments = std::move(*Self.Latest);
+			Self.Latest.reset();
+			Self.Wheel.Schedule(Self.Cooldown, Self.Interval);
+			Self.Emit(Arguments);
+		}
+	}
+
+public:
+	/**
+	 * @brief Connect to a source signal
+	 *
+	 * @param Source Signal to be throttled
+	 * @param Timers Wheel shared by the adapters
+	 * @param Period Minimum time between two fires
+	 */
+	template <typename Signal> ThrottledSignal(Signal& Source, ScriptTimerWheel& Timers, ScriptTimerWheel::Clock::duration Period)
+		: Wheel(Timers), Interval(Period) {
+		this->Listen(Source);
+	}
+};
+
+/**
+ * @brief Class of signal firing once its source stopped firing for an interval
+ *
+ * Every fire of the source replaces the pending arguments and restarts
+ * the interval, so a burst of fires makes a single fire with the last
+ * arguments, an interval after the burst
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class DebouncedSignal final : public ScriptAdapter<DebouncedSignal<Parameters...>, Parameters...> {
+protected:
+	friend ScriptAdapter<DebouncedSignal, Parameters...>;
+
+	/** Base class connecting to the source */
+	using Adapter = ScriptAdapter<DebouncedSignal, Parameters...>;
+
+	/** Copy of the arguments of a fire */
+	using typename Adapter::Event;
+
+	/** Wheel of the quiet interval's timer */
+	ScriptTimerWheel& Wheel;
+
+	/** Time without fires before firing */
+	ScriptTimerWheel::Clock::duration Interval;
+
+	/** Last fire of the source */
+	std::optional<Event> Latest;
+
+	/** Ends the quiet interval */
+	ScriptTimerWheel::Timer Quiet{&DebouncedSignal::Expire, this};
+
+	/**
+	 * @brief Keep the arguments and restart the interval
+	 *
+	 * @param Arguments Arguments of the source's fire
+	 */
+	void Receive(ScriptArgument<Parameters>... Arguments) {
+		Latest.emplace(Arguments...);
+		Wheel.Schedule(Quiet, Interval);
+	}
+
+	/** Fire the kept arguments */
+	static void Expire(void* Owner) {
+		DebouncedSignal& Self = *static_cast<DebouncedSignal*>(Owner);
+		Event Arguments = std::move(*Self.Latest);
+		Self.Latest.reset();
+		Self.Emit(Arguments);
+	}
+
+public:
+	/**
+	 * @brief Connect to a source signal
+	 *
+	 * @param Source Signal to be debounced
+	 * @param Timers Wheel shared by the adapters
+	 * @param Period Time without fires before firing
+	 */
+	template <typename Signal> DebouncedSignal(Signal& Source, ScriptTimerWheel& Timers, ScriptTimerWheel::Clock::duration Period)
+		: Wheel(Timers), Interval(Period) {
+		this->Listen(Source);
+	}
+};
+
+/**
+ * @brief Class of signal firing once every Count fires of its source
+ *
+ * Needs no timer: the other fires only increase a counter, so the
+ * functions only run for one fire out of Count
+ *
+ * @tparam Parameters The parameters to be used in function of connection
+ */
+template <typename... Parameters> class SampledSignal final : public ScriptAdapter<SampledSignal<Parameters...>, Parameters...> {
+protected:
+	friend ScriptAdapter<SampledSignal, Parameters...>;
+
+	/** Base class connecting to the source */
+	using Adapter = ScriptAdapter<SampledSignal, Parameters...>;
+
+	/** Fires of the source per fire */
+	std::size_t Period;
+
+	/** Fires of the source since the last fire */
+	std::size_t Skipped = 0;
+
+	/**
+	 * @brief Fire on every Period-th fire of the source
+	 *
+	 * @param Arguments Arguments of the source's fire
+	 */
+	void Receive(ScriptArgument<Parameters>... Arguments) {
+		if (++Skipped < Period) {
+			return;
+		}
+
+		Skipped = 0;
+		this->Fire(Arguments...);
+	}
+
+public:
+	/**
+	 * @brief Connect to a source signal
+	 *
+	 * @param Source Signal to be sampled
+	 * @param Count Fires of the source per fire, the first fire being the Count-th
+	 */
+	template <typename Signal> SampledSignal(Signal& Source, std::size_t Count) : Period(std::max<std::size_t>(Count, 1)) {
+		this->Listen(Source);
+	}
+};
+
+#undef f_
+#endif